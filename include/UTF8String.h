@@ -178,10 +178,26 @@ namespace XCSP3Core {
 
         friend std::ostream& operator<<(std::ostream& f, const UTF8String s);
 
+        /**
+         * returns true iff the bytes of [b, e) are all ASCII (no UTF8 decoding needed)
+         */
+        static bool isAscii(const Byte* b, const Byte* e);
+
+        /**
+         * decodes the integer [+-]digits which starts at b (like std::from_chars) and returns the end of its digits,
+         * or b if there is no integer. Throws an exception if it does not fit an int
+         */
+        static const Byte* parseInteger(const Byte* b, const Byte* e, int& v);
+
         class Tokenizer {
         private:
+            // Classes of bytes, a token stops on any byte which is not TOKEN
+            enum : Byte { TOKEN = 0, SPACE = 1, SEPARATOR = 2, END = 4 };
+
             iterator it, end;
-            std::vector<int> separators;
+            bool ascii;                 // the text is ASCII: bytes are characters
+            Byte classes[256];          // class of each ASCII character
+            std::vector<int> separators; // non ASCII separators
 
         public:
             Tokenizer(const UTF8String s);
@@ -191,6 +207,8 @@ namespace XCSP3Core {
 
         protected:
             inline bool isSeparator(int ch) {
+                if (ch < 128)
+                    return classes[ch] & SEPARATOR;
                 for (std::vector<int>::const_iterator it = separators.begin();
                      it != separators.end(); ++it)
                     if (*it == ch)
@@ -200,8 +218,10 @@ namespace XCSP3Core {
             }
 
             inline void skipWhiteSpace() {
-                while (it != end && *it && it.isWhiteSpace())
-                    ++it;
+                const Byte *p = it.getPointer(), *e = end.getPointer();
+                while (p != e && (classes[*p] & SPACE))
+                    ++p;
+                it = iterator(p);
             }
         };
 
@@ -29,7 +29,6 @@
 #include "XCSP3Variable.h"
 #include "XCSP3utils.h"
 #include <map>
-#include <regex>
 #include <typeinfo>
 
 namespace XCSP3Core {
@@ -43,11 +42,11 @@ namespace XCSP3Core {
      **************************************************************************/
     class XConstraint {
     public:
-        std::string id;
+        XString id;
         std::vector<XVariable*> list;
-        std::string classes;
+        XString classes;
 
-        XConstraint(std::string dd, std::string c) : id(dd), classes(c) {}
+        XConstraint(XString dd, XString c) : id(dd), classes(c) {}
 
         virtual ~XConstraint() {}
 
@@ -65,8 +64,9 @@ namespace XCSP3Core {
         std::vector<std::vector<XVariable*>> arguments; // The list of all arguments
         ConstraintType type;                            // Use it to discover the type of constraint... and perform cast
         std::map<std::string, XVariable*> toArguments;
+        int maxParameter; // the greatest i of %i in the template, -1 if none
 
-        XConstraintGroup(std::string idd, std::string c) : XConstraint(idd, c), constraint(NULL), type(ConstraintType::UNKNOWN) {}
+        XConstraintGroup(XString idd, XString c) : XConstraint(idd, c), constraint(NULL), type(ConstraintType::UNKNOWN), maxParameter(-1) {}
 
         virtual ~XConstraintGroup() {  }
 
@@ -95,6 +95,7 @@ namespace XCSP3Core {
 
         virtual void unfoldParameters(XConstraintGroup* group, std::vector<XVariable*>& arguments, XConstraint* original);
         void extractCondition(XCondition& xc); // Create the op and the operand (which can be a value, an interval or a XVariable)
+        static bool parseCondition(const std::string& condition, XCondition& xc); // Same thing, false if the condition is malformed
     };
 
     class XValues {
@@ -139,7 +140,7 @@ namespace XCSP3Core {
         bool isSupport;
         bool containsStar;
 
-        XConstraintExtension(std::string idd, std::string c) : XConstraint(idd, c), containsStar(false) {}
+        XConstraintExtension(XString idd, XString c) : XConstraint(idd, c), containsStar(false) {}
 
         void unfoldParameters(XConstraintGroup* group, std::vector<XVariable*>& arguments, XConstraint* original) override;
     };
@@ -152,7 +153,7 @@ namespace XCSP3Core {
     public:
         std::string function;
 
-        XConstraintIntension(std::string idd, std::string c) : XConstraint(idd, c) {}
+        XConstraintIntension(XString idd, XString c) : XConstraint(idd, c) {}
 
         void unfoldParameters(XConstraintGroup* group, std::vector<XVariable*>& arguments, XConstraint* original) override;
     };
@@ -175,9 +176,16 @@ namespace XCSP3Core {
         std::string to;
     };
 
-    extern std::vector<XTransition> tr; // Not beautiful but remove code to fixed data in group constraint.
-    extern std::string st;
-    extern std::vector<std::string> fi;
+    // Not beautiful but remove code to fixed data in group constraint.
+    // The constraints of a group share these fields by reference, there is one per parse (see DataPool)
+    struct XGroupData {
+        std::vector<XTransition> tr;
+        std::string st;
+        std::vector<std::string> fi;
+        std::vector<int> _except;
+        OrderType _op;
+        std::vector<int> _values;
+    };
 
     class XConstraintRegular : public XConstraint {
     public:
@@ -185,7 +193,7 @@ namespace XCSP3Core {
         std::vector<std::string>& final;
         std::vector<XTransition>& transitions;
 
-        XConstraintRegular(std::string idd, std::string c) : XConstraint(idd, c), start(st), final(fi), transitions(tr) {}
+        XConstraintRegular(XString idd, XString c) : XConstraint(idd, c), start(DataPool::current().groupData->st), final(DataPool::current().groupData->fi), transitions(DataPool::current().groupData->tr) {}
     };
 
     /***************************************************************************
@@ -196,7 +204,7 @@ namespace XCSP3Core {
     public:
         std::vector<XTransition>& transitions;
 
-        XConstraintMDD(std::string idd, std::string c) : XConstraint(idd, c), transitions(tr) {}
+        XConstraintMDD(XString idd, XString c) : XConstraint(idd, c), transitions(DataPool::current().groupData->tr) {}
     };
 
     /***************************************************************************
@@ -204,22 +212,20 @@ namespace XCSP3Core {
      *                  COMPARISON BASED CONSTRAINTS
      ****************************************************************************
      ***************************************************************************/
-    extern std::vector<int> _except;
-
     class XConstraintAllDiff : public XConstraint {
     public:
         std::vector<int>& except;
 
-        XConstraintAllDiff(std::string idd, std::string c) : XConstraint(idd, c), except(_except) {}
+        XConstraintAllDiff(XString idd, XString c) : XConstraint(idd, c), except(DataPool::current().groupData->_except) {}
     };
 
     class XConstraintAllDiffMatrix : public XConstraint {
     public:
         std::vector<std::vector<XVariable*>> matrix;
 
-        XConstraintAllDiffMatrix(std::string idd, std::string c) : XConstraint(idd, c) {}
+        XConstraintAllDiffMatrix(XString idd, XString c) : XConstraint(idd, c) {}
 
-        XConstraintAllDiffMatrix(std::string idd, std::string c, std::vector<std::vector<XVariable*>>& mat) : XConstraint(idd, c) {
+        XConstraintAllDiffMatrix(XString idd, XString c, std::vector<std::vector<XVariable*>>& mat) : XConstraint(idd, c) {
             matrix.resize(mat.size());
             for (unsigned int i = 0; i < mat.size(); i++)
                 matrix[i].assign(mat[i].begin(), mat[i].end());
@@ -236,13 +242,11 @@ namespace XCSP3Core {
      * constraint ordered and lex
      **************************************************************************/
 
-    extern OrderType _op;
-
     class XConstraintOrdered : public XConstraint, public XLengths {
     public:
         OrderType& op;
 
-        XConstraintOrdered(std::string idd, std::string c) : XConstraint(idd, c), op(_op) {}
+        XConstraintOrdered(XString idd, XString c) : XConstraint(idd, c), op(DataPool::current().groupData->_op) {}
         void unfoldParameters(XConstraintGroup* group, std::vector<XVariable*>& arguments, XConstraint* original) override;
     };
 
@@ -251,7 +255,7 @@ namespace XCSP3Core {
         // list is cleard and all lists are stored in lists
         std::vector<std::vector<XVariable*>> lists;
 
-        XConstraintLex(std::string idd, std::string c) : XConstraintOrdered(idd, c) {}
+        XConstraintLex(XString idd, XString c) : XConstraintOrdered(idd, c) {}
 
         void unfoldParameters(XConstraintGroup* group, std::vector<XVariable*>& arguments, XConstraint* original) override;
     };
@@ -260,7 +264,7 @@ namespace XCSP3Core {
     public:
         std::vector<std::vector<XVariable*>> matrix;
 
-        XConstraintLexMatrix(std::string idd, std::string c) : XConstraintOrdered(idd, c) {}
+        XConstraintLexMatrix(XString idd, XString c) : XConstraintOrdered(idd, c) {}
 
         void unfoldParameters(XConstraintGroup* group, std::vector<XVariable*>& arguments, XConstraint* original) override;
     };
@@ -281,7 +285,7 @@ namespace XCSP3Core {
     public:
         //     vector<int> &coeffs;
 
-        XConstraintSum(std::string idd, std::string c) : XConstraint(idd, c) {}
+        XConstraintSum(XString idd, XString c) : XConstraint(idd, c) {}
 
         void unfoldParameters(XConstraintGroup* group, std::vector<XVariable*>& arguments, XConstraint* original) override;
     };
@@ -290,7 +294,7 @@ namespace XCSP3Core {
     public:
         std::vector<int>& except;
 
-        XConstraintNValues(std::string idd, std::string c) : XConstraint(idd, c), except(_except) {}
+        XConstraintNValues(XString idd, XString c) : XConstraint(idd, c), except(DataPool::current().groupData->_except) {}
 
         void unfoldParameters(XConstraintGroup* group, std::vector<XVariable*>& arguments, XConstraint* original) override;
     };
@@ -300,7 +304,7 @@ namespace XCSP3Core {
         std::vector<XVariable*> occurs;
         bool closed;
 
-        XConstraintCardinality(std::string idd, std::string c) : XConstraint(idd, c) {}
+        XConstraintCardinality(XString idd, XString c) : XConstraint(idd, c) {}
 
         void unfoldParameters(XConstraintGroup* group, std::vector<XVariable*>& arguments, XConstraint* original) override;
     };
@@ -311,7 +315,7 @@ namespace XCSP3Core {
 
     class XConstraintCount : public XConstraint, public XInitialCondition, public XValues {
     public:
-        XConstraintCount(std::string idd, std::string c) : XConstraint(idd, c) {}
+        XConstraintCount(XString idd, XString c) : XConstraint(idd, c) {}
 
         void unfoldParameters(XConstraintGroup* group, std::vector<XVariable*>& arguments, XConstraint* original) override;
     };
@@ -333,7 +337,7 @@ namespace XCSP3Core {
         int startIndex;
         RankType rank;
 
-        XConstraintMaximum(std::string idd, std::string c) : XConstraint(idd, c), startIndex(0), rank(RankType::ANY) {}
+        XConstraintMaximum(XString idd, XString c) : XConstraint(idd, c), startIndex(0), rank(RankType::ANY) {}
 
         void unfoldParameters(XConstraintGroup* group, std::vector<XVariable*>& arguments, XConstraint* original) override;
     };
@@ -349,7 +353,7 @@ namespace XCSP3Core {
         int startIndex;
         RankType rank;
 
-        XConstraintElement(std::string idd, std::string c) : XConstraint(idd, c), startIndex(0), rank(RankType::ANY) {}
+        XConstraintElement(XString idd, XString c) : XConstraint(idd, c), startIndex(0), rank(RankType::ANY) {}
 
         void unfoldParameters(XConstraintGroup* group, std::vector<XVariable*>& arguments, XConstraint* original) override;
     };
@@ -360,9 +364,9 @@ namespace XCSP3Core {
         XVariable* index2;
         int startRowIndex, startColIndex;
 
-        XConstraintElementMatrix(std::string idd, std::string c) : XConstraintElement(idd, c) {}
+        XConstraintElementMatrix(XString idd, XString c) : XConstraintElement(idd, c) {}
 
-        XConstraintElementMatrix(std::string idd, std::string c, std::vector<std::vector<XVariable*>>& mat) : XConstraintElement(idd, c) {
+        XConstraintElementMatrix(XString idd, XString c, std::vector<std::vector<XVariable*>>& mat) : XConstraintElement(idd, c) {
             matrix.resize(mat.size());
             for (unsigned int i = 0; i < mat.size(); i++)
                 matrix[i].assign(mat[i].begin(), mat[i].end());
@@ -381,7 +385,7 @@ namespace XCSP3Core {
         int startIndex1;
         int startIndex2;
 
-        XConstraintChannel(std::string idd, std::string c) : XConstraint(idd, c), startIndex1(0), startIndex2(0) {}
+        XConstraintChannel(XString idd, XString c) : XConstraint(idd, c), startIndex1(0), startIndex2(0) {}
 
         void unfoldParameters(XConstraintGroup* group, std::vector<XVariable*>& arguments, XConstraint* original) override;
     };
@@ -402,7 +406,7 @@ namespace XCSP3Core {
         std::vector<XVariable*>& origins;
         bool zeroIgnored;
 
-        XConstraintNoOverlap(std::string idd, std::string c) : XConstraint(idd, c), origins(list) {}
+        XConstraintNoOverlap(XString idd, XString c) : XConstraint(idd, c), origins(list) {}
 
         void unfoldParameters(XConstraintGroup* group, std::vector<XVariable*>& arguments, XConstraint* original) override;
     };
@@ -417,7 +421,7 @@ namespace XCSP3Core {
         std::vector<XVariable*> ends;
         std::vector<XVariable*> heights;
 
-        XConstraintCumulative(std::string idd, std::string c) : XConstraint(idd, c), origins(list) {}
+        XConstraintCumulative(XString idd, XString c) : XConstraint(idd, c), origins(list) {}
 
         void unfoldParameters(XConstraintGroup* group, std::vector<XVariable*>& arguments, XConstraint* original) override;
     };
@@ -432,7 +436,7 @@ namespace XCSP3Core {
         std::vector<XInterval> widths; // interval
         std::vector<std::vector<int>> patterns;
 
-        XConstraintStretch(std::string idd, std::string c) : XConstraint(idd, c) {}
+        XConstraintStretch(XString idd, XString c) : XConstraint(idd, c) {}
 
         // Group is valied with lists only.
         void unfoldParameters(XConstraintGroup* group, std::vector<XVariable*>& arguments, XConstraint* original) override;
@@ -442,13 +446,11 @@ namespace XCSP3Core {
      * constraint instantiation
      **************************************************************************/
 
-    extern std::vector<int> _values;
-
     class XConstraintInstantiation : public XConstraint {
     public:
         std::vector<int>& values;
 
-        XConstraintInstantiation(std::string idd, std::string c) : XConstraint(idd, c), values(_values) {}
+        XConstraintInstantiation(XString idd, XString c) : XConstraint(idd, c), values(DataPool::current().groupData->_values) {}
     };
 
     /***************************************************************************
@@ -460,7 +462,7 @@ namespace XCSP3Core {
         std::vector<XVariable*> positive;
         std::vector<XVariable*> negative;
 
-        XConstraintClause(std::string idd, std::string c) : XConstraint(idd, c) {}
+        XConstraintClause(XString idd, XString c) : XConstraint(idd, c) {}
         void unfoldParameters(XConstraintGroup* group, std::vector<XVariable*>& arguments, XConstraint* original) override;
     };
 
@@ -472,7 +474,7 @@ namespace XCSP3Core {
 
     class XConstraintCircuit : public XConstraint, public XValue { // value => size
     public:
-        XConstraintCircuit(std::string idd, std::string c) : XConstraint(idd, c) {}
+        XConstraintCircuit(XString idd, XString c) : XConstraint(idd, c) {}
         int startIndex;
 
         void unfoldParameters(XConstraintGroup* group, std::vector<XVariable*>& arguments, XConstraint* original) override;
@@ -131,6 +131,68 @@ namespace XCSP3Core {
          */
         virtual void endGroup() {}
 
+        /**
+         * If  #nativeConstraintGroups is enabled, a group of constraints is given as a template and its arguments
+         * The template is not unfolded: its parameters are XParameterVariable (or %i in strings)
+         * Arguments are given as a flat matrix: the row r of the group is arguments[r * arity ... (r + 1) * arity - 1]
+         * Groups whose rows have different sizes are not given.
+         * See http://xcsp.org/specifications/groups
+         *
+         * @param id the id (name) of the group
+         * @param type the type of the template, use it to cast the constraint
+         * @param constraint the template
+         * @param arguments the arguments of the group, row by row
+         * @param arity the size of each row
+         * @return true if the group is handled, otherwise the constraints of the group are unfolded as usual
+         */
+        virtual bool buildConstraintGroup(const std::string& id, ConstraintType type, XConstraint* constraint, std::vector<XVariable*>& arguments, int arity) {
+            (void)id;
+            (void)type;
+            (void)constraint;
+            (void)arguments;
+            (void)arity;
+            return false;
+        }
+
+        /**
+         * If  #nativeArraySlices is enabled, a constraint (allDifferent, allEqual, ordered or sum) that is not in a group and whose list is
+         * exactly one compact form of an array (ex: x[][] or x[0..999][]) is given with the slice of the array, without listing its variables.
+         * Only an ordered without lengths and a sum without coefficients are given as a slice, other fields are set (op, condition).
+         *
+         * @param id the id (name) of the constraint
+         * @param type ALLDIFF, ALLEQUAL, ORDERED or SUM, use it to cast the constraint (op for ordered, extractCondition for sum)
+         * @param constraint the constraint, its list is empty
+         * @param slice the cells of the array
+         * @return true if the constraint is handled, otherwise the list is expanded and the usual callback is called
+         */
+        virtual bool buildConstraintSlice(const std::string& id, ConstraintType type, XConstraint* constraint, XArraySlice& slice) {
+            (void)id;
+            (void)type;
+            (void)constraint;
+            (void)slice;
+            return false;
+        }
+
+        /**
+         * If  #nativeConstraintGroups is enabled, a group of intensional constraints is first given with the tree of its template
+         * (and then to the previous function if it is not handled)
+         * The tree is not canonized, parameters are unbound variables named %0, %1... (other variables give their XVariable)
+         * Not used if  #intensionUsingString is true.
+         *
+         * @param id the id (name) of the group
+         * @param tree the tree of the template
+         * @param arguments the arguments of the group, row by row
+         * @param arity the size of each row
+         * @return true if the group is handled
+         */
+        virtual bool buildConstraintGroup(const std::string& id, Tree* tree, std::vector<XVariable*>& arguments, int arity) {
+            (void)id;
+            (void)tree;
+            (void)arguments;
+            (void)arity;
+            return false;
+        }
+
         /**
          * Start to parse a block of constraints
          * Related to tag <block>
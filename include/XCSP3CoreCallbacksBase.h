@@ -29,17 +29,56 @@
 #include "XCSP3Constraint.h"
 #include "XCSP3Tree.h"
 #include "XCSP3Variable.h"
+#include "XCSP3utils.h"
+#include <algorithm>
+#include <functional>
 #include <string>
 #include <vector>
 
 namespace XCSP3Core {
 
+    /**
+     * Counters maintained by the parser while an instance is read.
+     * They are reset at the beginning of each instance, see XCSP3CoreCallbacksBase::statistics()
+     */
+    struct XParserStatistics {
+        unsigned long intensionCacheHits;   // intension constraints built from a cached template
+        unsigned long intensionCacheMisses; // intension constraints parsed and canonized from scratch
+        unsigned long distinctNodes;        // tree nodes created when hashConsNodes is true
+        unsigned long sharedNodes;          // tree nodes obtained from an equal one when hashConsNodes is true
+
+        XParserStatistics() : intensionCacheHits(0), intensionCacheMisses(0), distinctNodes(0), sharedNodes(0) {}
+
+        double intensionCacheHitRate() const {
+            unsigned long total = intensionCacheHits + intensionCacheMisses;
+            return total == 0 ? 0.0 : static_cast<double>(intensionCacheHits) / static_cast<double>(total);
+        }
+    };
+
+    /**
+     * A pattern of intensional constraint registered with XCSP3CoreCallbacksBase::addIntensionPattern
+     * post is called with the id of the constraint, its canonized tree and, in prefix order, the operators, constants and variables
+     * matched by the pattern. It returns true if the constraint is posted, false otherwise (nothing must be done in that case).
+     */
+    struct XIntensionPattern {
+        typedef std::function<bool(const std::string& id, Tree* tree, std::vector<Expr>& operators, std::vector<int>& constants, std::vector<XVariable*>& variables)> Post;
+
+        std::string expression;
+        bool anyOperatorAtRoot;
+        Post post;
+
+        XIntensionPattern(const std::string& e, bool any, Post p) : expression(e), anyOperatorAtRoot(any), post(p) {}
+    };
+
     class XCSP3CoreCallbacksBase {
         friend class XCSP3Manager;
 
     protected:
         std::vector<std::string> classesToDiscard;
+        std::vector<XIntensionPattern> intensionPatterns;
         std::vector<std::vector<XVariable*>>* _arguments;
+        XParserStatistics _statistics;
+        bool _retained;
 
     public:
         /**
@@ -71,12 +110,94 @@ namespace XCSP3Core {
          */
         bool normalizeSum;
 
+        /**
+         * If true, intension constraints that differ only by the names of their variables share the same
+         * canonized tree and primitive recognition: the first one is parsed and canonized, the following ones
+         * are obtained by binding their variables into the cached tree (true by default).
+         * Not used when intensionUsingString is true.
+         */
+        bool cacheIntensionTemplates;
+
+        /**
+         * If true, structurally equal nodes of trees are shared: a subexpression used by many constraints is created once
+         * (false by default). Then, trees given to callbacks must not be modified.
+         */
+        bool hashConsNodes;
+
+        /**
+         * If true, each group of constraints is first given to #buildConstraintGroup (false by default).
+         * If the callback handles it, the constraints of the group are not unfolded.
+         */
+        bool nativeConstraintGroups;
+
+        /**
+         * If greater than 1, the rows of large groups (at least 1024 constraints) are unfolded by this number of threads
+         * (1 by default, never more than the number of cores). Only the making of the rows is parallel: arguments are
+         * substituted and, for intensional groups, the trees are parsed and canonized. Primitive recognition and callbacks
+         * are done by the thread that parses, in the order of the rows.
+         * Not used (rows are made sequentially) for slides, extension groups, groups handled by #buildConstraintGroup and
+         * intensional groups when #cacheIntensionTemplates is true (the default, rows are bound to compiled templates):
+         * set #cacheIntensionTemplates to false for intensional groups to be unfolded in parallel.
+         */
+        int unfoldingThreads;
+
+        /**
+         * If true, the objects made for a constraint, a group or a slide (lists, tuples, trees, constants...) are released
+         * as soon as its callbacks return (false by default): the memory used by the parser does not grow with the number of constraints.
+         * Then, everything given to a constraint callback must be copied, except the variables declared in <variables>,
+         * unless #retainConstraint is called by the callback.
+         */
+        bool releaseConstraints;
+
+        /**
+         * If true, some constraints whose list is a compact form of an array are first given to #buildConstraintSlice
+         * (false by default): the variables of the array are not listed.
+         */
+        bool nativeArraySlices;
+
+        /**
+         * If true, the section <annotations> is skipped while reading the file (false by default):
+         * #beginAnnotations, #endAnnotations and #buildAnnotationDecision are not called.
+         */
+        bool skipAnnotations;
+
+        /**
+         * If true, the section <objectives> is skipped while reading the file (false by default), for instance
+         * to only check the satisfiability of an optimization problem: the callbacks of objectives are not called.
+         */
+        bool skipObjectives;
+
         XCSP3CoreCallbacksBase() {
             intensionUsingString = false;
             recognizeSpecialIntensionCases = true;
             recognizeSpecialCountCases = true;
             recognizeNValuesCases = true;
             normalizeSum = true;
+            cacheIntensionTemplates = true;
+            hashConsNodes = false;
+            nativeConstraintGroups = false;
+            unfoldingThreads = 1;
+            releaseConstraints = false;
+            nativeArraySlices = false;
+            skipAnnotations = false;
+            skipObjectives = false;
+            _retained = false;
+        }
+
+        /**
+         * Used with #releaseConstraints: called by a constraint callback, the objects of the current constraint (or group, slide)
+         * are kept until the end of the parse.
+         */
+        void retainConstraint() {
+            _retained = true;
+        }
+
+        /**
+         * Counters related to the current parse (cache hits...)
+         * @return the statistics
+         */
+        const XParserStatistics& statistics() const {
+            return _statistics;
         }
 
         /**
@@ -87,13 +208,28 @@ namespace XCSP3Core {
             classesToDiscard.push_back(cl);
         }
 
-        bool discardedClasses(const std::string& classes) {
-            if (classes == "")
-                return false;
+        /**
+         * Add a pattern of intensional constraint, used when recognizeSpecialIntensionCases is true.
+         * Patterns are tried on canonized trees, after the ones of the parser, in the order they are added.
+         * In the expression, each variable (resp. constant) matches any variable (resp. constant)
+         * and a set matches any set of constants. Ex: "eq(add(x,3),y)"
+         * Since trees are canonized, the pattern must be written in canonized form (ex: le(3,x) rather than ge(x,3))
+         * @param expression the pattern
+         * @param anyOperatorAtRoot if true, the operator at the root matches any operator with the same number of parameters
+         * @param post the function called when a canonized tree matches the pattern
+         */
+        void addIntensionPattern(const std::string& expression, bool anyOperatorAtRoot, XIntensionPattern::Post post) {
+            intensionPatterns.push_back(XIntensionPattern(expression, anyOperatorAtRoot, post));
+        }
 
-            for (std::string c : classesToDiscard)
-                if (classes.find(c) != std::string::npos)
-                    return true;
+        // True if one of the classes (separated by spaces) is to discard, the parser uses a compiled filter (XCSP3Manager)
+        bool discardedClasses(const std::string& classes) {
+            for (size_t end = 0, begin; (begin = classes.find_first_not_of(" \t\n\r", end)) != std::string::npos;) {
+                end = std::min(classes.find_first_of(" \t\n\r", begin), classes.size());
+                for (const std::string& c : classesToDiscard)
+                    if (classes.compare(begin, end - begin, c) == 0)
+                        return true;
+            }
             return false;
         }
 
@@ -187,6 +323,49 @@ namespace XCSP3Core {
          */
         virtual void endGroup() = 0;
 
+        /**
+         * If  #nativeConstraintGroups is enabled, a group of constraints is given as a template and its arguments
+         * The template is not unfolded: its parameters are XParameterVariable (or %i in strings)
+         * Arguments are given as a flat matrix: the row r of the group is arguments[r * arity ... (r + 1) * arity - 1]
+         * Groups whose rows have different sizes are not given.
+         * See http://xcsp.org/specifications/groups
+         *
+         * @param id the id (name) of the group
+         * @param type the type of the template, use it to cast the constraint
+         * @param constraint the template
+         * @param arguments the arguments of the group, row by row
+         * @param arity the size of each row
+         * @return true if the group is handled, otherwise the constraints of the group are unfolded as usual
+         */
+        virtual bool buildConstraintGroup(const std::string& id, ConstraintType type, XConstraint* constraint, std::vector<XVariable*>& arguments, int arity) = 0;
+
+        /**
+         * If  #nativeArraySlices is enabled, a constraint (allDifferent, allEqual, ordered or sum) that is not in a group and whose list is
+         * exactly one compact form of an array (ex: x[][] or x[0..999][]) is given with the slice of the array, without listing its variables.
+         * Only an ordered without lengths and a sum without coefficients are given as a slice, other fields are set (op, condition).
+         *
+         * @param id the id (name) of the constraint
+         * @param type ALLDIFF, ALLEQUAL, ORDERED or SUM, use it to cast the constraint (op for ordered, extractCondition for sum)
+         * @param constraint the constraint, its list is empty
+         * @param slice the cells of the array
+         * @return true if the constraint is handled, otherwise the list is expanded and the usual callback is called
+         */
+        virtual bool buildConstraintSlice(const std::string& id, ConstraintType type, XConstraint* constraint, XArraySlice& slice) = 0;
+
+        /**
+         * If  #nativeConstraintGroups is enabled, a group of intensional constraints is first given with the tree of its template
+         * (and then to the previous function if it is not handled)
+         * The tree is not canonized, parameters are unbound variables named %0, %1... (other variables give their XVariable)
+         * Not used if  #intensionUsingString is true.
+         *
+         * @param id the id (name) of the group
+         * @param tree the tree of the template
+         * @param arguments the arguments of the group, row by row
+         * @param arity the size of each row
+         * @return true if the group is handled
+         */
+        virtual bool buildConstraintGroup(const std::string& id, Tree* tree, std::vector<XVariable*>& arguments, int arity) = 0;
+
         /**
          * Start to parse a block of constraints
          * Related to tag <block>
@@ -358,6 +537,52 @@ namespace XCSP3Core {
          */
         virtual void buildConstraintExtensionAs(const std::string& id, std::vector<XVariable*> list, bool support, bool hasStar) = 0;
 
+        /**
+         * The parser calls this function for a constraint in extension (not unary): the scope is given without copy.
+         * By default, the scope is copied and the previous callback buildConstraintExtension is called.
+         * Override this one to avoid the copy. The span is valid only during the call.
+         *
+         * @param id the id (name) of the constraint
+         * @param list the scope of the constraint
+         * @param tuples the set of tuples in the constraint
+         * @param support  support or conflicts?
+         * @param hasStar is the tuples contain star values?
+         */
+        virtual void buildConstraintExtensionSpan(const std::string& id, XSpan<XVariable*> list, std::vector<std::vector<int>>& tuples, bool support, bool hasStar) {
+            buildConstraintExtension(id, list.toVector(), tuples, support, hasStar);
+        }
+
+        /**
+         * The parser calls this function for a constraint in extension with the tuples of the previous one (see buildConstraintExtensionAs).
+         * By default, the scope is copied and buildConstraintExtensionAs is called.
+         */
+        virtual void buildConstraintExtensionAsSpan(const std::string& id, XSpan<XVariable*> list, bool support, bool hasStar) {
+            buildConstraintExtensionAs(id, list.toVector(), support, hasStar);
+        }
+
+        /**
+         * The parser calls this function for a constraint in extension that is not in a group: the tuples are given to the callback,
+         * that can take them without copy (std::move). After the call, the parser never reads these tuples again, it only destroys them.
+         * By default, buildConstraintExtensionSpan is called.
+         *
+         * @param id the id (name) of the constraint
+         * @param list the scope of the constraint
+         * @param tuples the set of tuples in the constraint
+         * @param support  support or conflicts?
+         * @param hasStar is the tuples contain star values?
+         */
+        virtual void buildConstraintExtensionOwned(const std::string& id, XSpan<XVariable*> list, std::vector<std::vector<int>>&& tuples, bool support, bool hasStar) {
+            buildConstraintExtensionSpan(id, list, tuples, support, hasStar);
+        }
+
+        /**
+         * The parser calls this function for every unary constraint in extension: the tuples can be taken without copy,
+         * the parser never reads them again. By default, the unary buildConstraintExtension is called.
+         */
+        virtual void buildConstraintExtensionOwned(const std::string& id, XVariable* variable, std::vector<int>&& tuples, bool support, bool hasStar) {
+            buildConstraintExtension(id, variable, tuples, support, hasStar);
+        }
+
         /**
          * The callback function related to a constraint in intension
          * Only called if intensionUsingString is set to true (otherwise the next function is called
@@ -461,6 +686,14 @@ namespace XCSP3Core {
          */
         virtual void buildConstraintRegular(const std::string& id, std::vector<XVariable*>& list, std::string start, std::vector<std::string>& final, std::vector<XTransition>& transitions) = 0;
 
+        /**
+         * The parser calls this function for a regular constraint that is not in a group: the transitions can be taken without copy
+         * (std::move), the parser never reads them again. By default, buildConstraintRegular is called.
+         */
+        virtual void buildConstraintRegularOwned(const std::string& id, std::vector<XVariable*>& list, std::string start, std::vector<std::string>& final, std::vector<XTransition>&& transitions) {
+            buildConstraintRegular(id, list, start, final, transitions);
+        }
+
         /**
          * The callback function related to a MDD constraint.
          * See http://xcsp.org/specifications/mdd
@@ -481,6 +714,14 @@ namespace XCSP3Core {
          */
         virtual void buildConstraintMDD(const std::string& id, std::vector<XVariable*>& list, std::vector<XTransition>& transitions) = 0;
 
+        /**
+         * The parser calls this function for a MDD constraint that is not in a group: the transitions can be taken without copy
+         * (std::move), the parser never reads them again. By default, buildConstraintMDD is called.
+         */
+        virtual void buildConstraintMDDOwned(const std::string& id, std::vector<XVariable*>& list, std::vector<XTransition>&& transitions) {
+            buildConstraintMDD(id, list, transitions);
+        }
+
         //--------------------------------------------------------------------------------------
         // Comparison constraints
         //--------------------------------------------------------------------------------------
@@ -694,6 +935,14 @@ namespace XCSP3Core {
         */
         virtual void buildConstraintSum(const std::string& id, std::vector<XVariable*>& list, std::vector<int>& coeffs, XCondition& cond) = 0;
 
+        /**
+         * The parser calls this function for every sum constraint with int coefficients (and variables): the coefficients can be taken
+         * without copy (std::move), the parser never reads them again. By default, buildConstraintSum is called.
+         */
+        virtual void buildConstraintSumOwned(const std::string& id, std::vector<XVariable*>& list, std::vector<int>&& coeffs, XCondition& cond) {
+            buildConstraintSum(id, list, coeffs, cond);
+        }
+
         /**
          * The callback function related to an sum constraint with all coefs are equal to one
          * See http://xcsp.org/specifications/sum
@@ -1054,6 +1303,50 @@ namespace XCSP3Core {
          * @param closed is the constraint is closed
          */
         virtual void buildConstraintCardinality(const std::string& id, std::vector<XVariable*>& list, std::vector<XVariable*> values, std::vector<XInterval>& occurs, bool closed) = 0;
+
+        /**
+         * The parser calls these functions for cardinality constraints: the list and the values are given without copy.
+         * The name gives the kind of the values then the kind of the occurs (Int, Var or Interval): each one has its own name,
+         * so overriding one of them does not hide the others.
+         * By default, the list and the values are copied and the related buildConstraintCardinality is called.
+         * Override them to avoid the copies. Spans and occurs are valid only during the call.
+         *
+         * @param id the id (name) of the constraint
+         * @param list the list of the constraint
+         * @param values the set of values (int or variables)
+         * @param occurs the number of occurences (int, variables or intervals)
+         * @param closed is the constraint is closed
+         */
+        virtual void buildConstraintCardinalityIntIntSpan(const std::string& id, XSpan<XVariable*> list, XSpan<int> values, std::vector<int>& occurs, bool closed) {
+            std::vector<XVariable*> scope = list.toVector();
+            buildConstraintCardinality(id, scope, values.toVector(), occurs, closed);
+        }
+
+        virtual void buildConstraintCardinalityIntVarSpan(const std::string& id, XSpan<XVariable*> list, XSpan<int> values, std::vector<XVariable*>& occurs, bool closed) {
+            std::vector<XVariable*> scope = list.toVector();
+            buildConstraintCardinality(id, scope, values.toVector(), occurs, closed);
+        }
+
+        virtual void buildConstraintCardinalityIntIntervalSpan(const std::string& id, XSpan<XVariable*> list, XSpan<int> values, std::vector<XInterval>& occurs, bool closed) {
+            std::vector<XVariable*> scope = list.toVector();
+            buildConstraintCardinality(id, scope, values.toVector(), occurs, closed);
+        }
+
+        virtual void buildConstraintCardinalityVarIntSpan(const std::string& id, XSpan<XVariable*> list, XSpan<XVariable*> values, std::vector<int>& occurs, bool closed) {
+            std::vector<XVariable*> scope = list.toVector();
+            buildConstraintCardinality(id, scope, values.toVector(), occurs, closed);
+        }
+
+        virtual void buildConstraintCardinalityVarVarSpan(const std::string& id, XSpan<XVariable*> list, XSpan<XVariable*> values, std::vector<XVariable*>& occurs, bool closed) {
+            std::vector<XVariable*> scope = list.toVector();
+            buildConstraintCardinality(id, scope, values.toVector(), occurs, closed);
+        }
+
+        virtual void buildConstraintCardinalityVarIntervalSpan(const std::string& id, XSpan<XVariable*> list, XSpan<XVariable*> values, std::vector<XInterval>& occurs, bool closed) {
+            std::vector<XVariable*> scope = list.toVector();
+            buildConstraintCardinality(id, scope, values.toVector(), occurs, closed);
+        }
+
         //--------------------------------------------------------------------------------------
         // Connection constraints
         //--------------------------------------------------------------------------------------
@@ -45,17 +45,37 @@ namespace XCSP3Core {
     class XCSP3CoreParser {
 
     protected:
+        DataPool pool; // all objects created by a parse, released at its end
         XMLParser cspParser;
+        xmlSAXHandler handler;
+        xmlParserCtxtPtr parserCtxt; // kept from one parse to the next one
+        std::unique_ptr<char[]> buffer;
+
+        static void initLibxml(); // once for the process
 
     public:
-        XCSP3CoreParser(XCSP3CoreCallbacksBase* cb) : cspParser(cb) {
-            LIBXML_TEST_VERSION
-        }
+        XCSP3CoreParser(XCSP3CoreCallbacksBase* cb);
+
+        ~XCSP3CoreParser();
 
+        XCSP3CoreParser(const XCSP3CoreParser&) = delete;
+        XCSP3CoreParser& operator=(const XCSP3CoreParser&) = delete;
+
+        /**
+         * parse can be called several times on the same parser, with different instances.
+         * Objects given to the callbacks (variables, trees...) are released at the end of each parse.
+         */
         int parse(std::istream& in);
 
         int parse(const char* filename);
 
+        /**
+         * Release the objects of the last parse and empty the state of the parser, but keep its tables,
+         * the libxml2 context and the capacities of its buffers. It is done at the end of each successful parse,
+         * and at the beginning of a parse following one interrupted by an exception.
+         */
+        void reset();
+
     protected:
         /*************************************************************************
          *
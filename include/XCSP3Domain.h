@@ -34,8 +34,15 @@
 
 namespace XCSP3Core {
 
+    // The concrete class of a XIntegerEntity, tested instead of using dynamic_cast
+    enum class IntegerEntityKind { VALUE, INTERVAL };
+
     class XIntegerEntity {
     public:
+        IntegerEntityKind kind;
+
+        XIntegerEntity(IntegerEntityKind k) : kind(k) {}
+
         virtual int width() = 0;
 
         virtual int minimum() = 0;
@@ -55,7 +62,7 @@ namespace XCSP3Core {
     public:
         int value;
 
-        XIntegerValue(int v) : value(v) {}
+        XIntegerValue(int v) : XIntegerEntity(IntegerEntityKind::VALUE), value(v) {}
 
         int width() override { return 1; }
 
@@ -66,10 +73,7 @@ namespace XCSP3Core {
         void print(std::ostream& O) const override { O << value << " "; }
 
         bool equals(XIntegerEntity* arg) override {
-            XIntegerValue* xiv;
-            if ((xiv = dynamic_cast<XIntegerValue*>(arg)) == NULL)
-                return false;
-            return value == xiv->value;
+            return arg->kind == IntegerEntityKind::VALUE && value == static_cast<XIntegerValue*>(arg)->value;
         }
 
         virtual ~XIntegerValue() {}
@@ -79,7 +83,7 @@ namespace XCSP3Core {
     public:
         int min, max;
 
-        XIntegerInterval(int inf, int sup) : min(inf), max(sup) {}
+        XIntegerInterval(int inf, int sup) : XIntegerEntity(IntegerEntityKind::INTERVAL), min(inf), max(sup) {}
 
         int width() override { return max - min + 1; }
 
@@ -90,9 +94,9 @@ namespace XCSP3Core {
         void print(std::ostream& O) const override { O << min << ".." << max << " "; }
 
         bool equals(XIntegerEntity* arg) override {
-            XIntegerInterval* xii;
-            if ((xii = dynamic_cast<XIntegerInterval*>(arg)) == NULL)
+            if (arg->kind != IntegerEntityKind::INTERVAL)
                 return false;
+            XIntegerInterval* xii = static_cast<XIntegerInterval*>(arg);
             return min == xii->min && max == xii->max;
         }
 
@@ -141,13 +145,13 @@ namespace XCSP3Core {
         void addValue(int v) {
             if (v <= top)
                 throw std::runtime_error{"not sequence domain"};
-            addEntity(DataPool::IntegerEntityPool.make<XIntegerValue>(top = v));
+            addEntity(DataPool::current().IntegerEntityPool.make<XIntegerValue>(top = v));
         }
 
         void addInterval(int min, int max) {
             if (min >= max || min <= top)
                 throw std::runtime_error{"not sequence domain"};
-            addEntity(DataPool::IntegerEntityPool.make<XIntegerInterval>(min, top = max));
+            addEntity(DataPool::current().IntegerEntityPool.make<XIntegerInterval>(min, top = max));
         }
 
         friend std::ostream& operator<<(std::ostream& f, const XDomainInteger& d);
@@ -32,42 +32,131 @@
 #include "XCSP3Variable.h"
 #include <XCSP3CoreCallbacks.h>
 #include <map>
-#include <regex>
 #include <string>
+#include <unordered_map>
 
 namespace XCSP3Core {
 
     class PrimitivePattern;
+    struct PatternTrieNode;
+    struct IntensionTemplate;
     class XCSP3Manager {
 
     public:
         XCSP3CoreCallbacksBase* callback;
         std::map<std::string, XEntity*>& mapping;
         std::string blockClasses;
+        bool blockDiscarded; // the classes of the current block are discarded
 
-        inline bool discardedClasses(std::string classes) {
-            return callback->discardedClasses(blockClasses) || callback->discardedClasses(classes);
+        // True if the current block or one of the classes (separated by spaces) is discarded by the callback
+        inline bool discardedClasses(const std::string& classes) {
+            return blockDiscarded || (classes.empty() == false && classesDiscarded(classes));
+        }
+
+        // True if one of the classes is discarded, the answer for each list of classes is computed once
+        bool classesDiscarded(const std::string& classes);
+
+        // True if some classes are to discard (otherwise class attributes need not be read)
+        inline bool discarding() const {
+            return callback->classesToDiscard.empty() == false;
         }
 
     private:
+        // Class filter: each class name has an id, the classes to discard are a bitset of ids
+        std::unordered_map<std::string, size_t> classIds;
+        std::vector<bool> discardedIds;
+        size_t nbCompiledClasses;                           // size of callback->classesToDiscard when the filter was compiled
+        std::unordered_map<std::string, bool> classVerdicts; // for each list of classes seen
+        size_t classId(const std::string& name);
+        void compileClassFilter();
+
         std::vector<XCSP3Core::PrimitivePattern*> patterns;
-        bool recognizePrimitives(std::string id, Tree* tree);
+        PatternTrieNode* patternTrie;   // discrimination tree over the prefix order of the patterns
+        std::vector<Node*> prefix;      // the canonized tree under recognition, in prefix order
+        std::vector<unsigned int> skip; // position following the subtree of prefix[i]
+        std::vector<int> candidates;    // patterns whose shape matches the canonized tree
+        int recognizePrimitives(std::string id, Tree* tree); // return the index of the recognized pattern, -1 otherwise
         void createPrimitivePatterns();
         void destroyPrimitivePatterns();
+        void addToPatternTrie(int index);
+        void collectCandidates(PatternTrieNode* node, unsigned int position);
+
+        // Intension constraints equal up to a renaming of their variables, indexed by their shape
+        std::unordered_map<std::string, IntensionTemplate*> intensionTemplates;
+        void destroyIntensionTemplates();
+        // Parse, canonize and post the constraint; the canonized tree is kept in a template if variables is not null
+        // (its nodes are made in nodes if not null)
+        IntensionTemplate* postIntension(const std::string& id, const std::string& function, std::vector<std::string>* variables, std::vector<XVariable*>* xvariables,
+                                         Pool<Node>* nodes = nullptr);
+        // Post the constraint obtained by binding the variables into the template
+        void postIntension(const std::string& id, IntensionTemplate* t, std::vector<std::string>& variables, std::vector<XVariable*>& xvariables);
+        // Post a constraint already canonized
+        void postIntension(const std::string& id, Tree* tree);
+        void newConstraintIntensionGroup(XConstraintGroup* group);
+
+        NodeFactory nodeFactory; // used if hashConsNodes is true
+
+        // Buffers reused for the arguments built for the callbacks (values, lengths, heights...), cleared before each use
+        std::vector<int> intScratch, intScratch2;
+        std::vector<XVariable*> varScratch, varScratch2;
+        std::vector<XInterval> intervalScratch;
+        Pool<Node> templateNodes; // canonized trees of intensionTemplates, kept when constraints are released
+        DataPool::Mark constraintMark; // see releaseConstraints
 
         void containsTrees(std::vector<XVariable*>& list, std::vector<Tree*>& newlist);
 
     public:
         // XCSP3CoreCallbacksBase *c, std::map<std::string, XEntity *> &m, bool
-        XCSP3Manager(XCSP3CoreCallbacksBase* c, std::map<std::string, XEntity*>& m, bool = true) : callback(c), mapping(m), blockClasses("") {}
+        XCSP3Manager(XCSP3CoreCallbacksBase* c, std::map<std::string, XEntity*>& m, bool = true) : callback(c), mapping(m), blockClasses(""), blockDiscarded(false), nbCompiledClasses(0), patternTrie(nullptr), templateNodes(false) {}
+
+        ~XCSP3Manager() {
+            reset();
+        }
+
+        // Forget what remains of a parse (interrupted by an exception for instance)
+        void reset() {
+            destroyPrimitivePatterns();
+            destroyIntensionTemplates();
+            templateNodes.clear(); // may be shared by the nodeFactory until the end of the parse
+            blockClasses = "";
+            blockDiscarded = false;
+            classIds.clear();
+            discardedIds.clear();
+            classVerdicts.clear();
+            nbCompiledClasses = 0;
+            nodeFactory.clear();
+            if (NodeFactory::current == &nodeFactory)
+                NodeFactory::current = nullptr;
+        }
 
         void beginInstance(InstanceType type) {
             callback->_arguments = nullptr;
+            callback->_statistics = XParserStatistics();
+            nodeFactory.clear();
+            NodeFactory::current = callback->hashConsNodes ? &nodeFactory : nullptr;
             callback->beginInstance(type);
         }
 
         void endInstance() {
+            callback->_statistics.distinctNodes = nodeFactory.created;
+            callback->_statistics.sharedNodes = nodeFactory.shared;
             callback->endInstance();
+            NodeFactory::current = nullptr;
+            nodeFactory.clear();
+        }
+
+        // With releaseConstraints, the objects made between these two calls (one constraint, group or slide) are released,
+        // unless the callback has retained them
+        void beginConstraintStorage() {
+            callback->_retained = false;
+            constraintMark = DataPool::current().mark();
+        }
+
+        void endConstraintStorage() {
+            if (callback->_retained)
+                return;
+            nodeFactory.forget();
+            DataPool::current().rewind(constraintMark);
         }
 
         void beginVariables() {
@@ -100,6 +189,7 @@ namespace XCSP3Core {
             callback->endConstraints();
             if (callback->recognizeSpecialIntensionCases)
                 destroyPrimitivePatterns();
+            destroyIntensionTemplates();
         }
 
         void beginSlide(std::string id, bool circular) {
@@ -129,6 +219,9 @@ namespace XCSP3Core {
         // Basic constraints
         //--------------------------------------------------------------------------------------
 
+        // Give a constraint whose list is a slice of an array (nativeArraySlices), return true if it is handled (or discarded)
+        bool newConstraintSlice(ConstraintType type, XConstraint* constraint, XArraySlice& slice);
+
         void newConstraintExtension(XConstraintExtension* constraint);
 
         void newConstraintExtensionAsLastOne(XConstraintExtension* constraint);
@@ -222,11 +315,13 @@ namespace XCSP3Core {
         //--------------------------------------------------------------------------------------
         void beginBlock(std::string classes) {
             blockClasses = classes;
+            blockDiscarded = classes.empty() == false && classesDiscarded(classes);
             callback->beginBlock(classes);
         }
 
         void endBlock() {
             blockClasses = "";
+            blockDiscarded = false;
             callback->endBlock();
         }
 
@@ -245,6 +340,13 @@ namespace XCSP3Core {
         template <class T>
         void unfoldConstraint(XConstraintGroup* group, int i, void (XCSP3Manager::*newConstraint)(T*));
 
+        template <class T>
+        void unfoldConstraintsInParallel(XConstraintGroup* group, void (XCSP3Manager::*newConstraint)(T*));
+
+        void unfoldGroupInParallel(XConstraintGroup* group);
+
+        bool buildConstraintGroup(XConstraintGroup* group);
+
         void newConstraintGroup(XConstraintGroup* group);
 
         //--------------------------------------------------------------------------------------
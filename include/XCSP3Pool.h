@@ -1,51 +1,281 @@
 #ifndef XPOOL_H
 #define XPOOL_H
 
-#include <vector>
-#include <memory>
-#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <iostream>
+#include <new>
+#include <string>
+#include <type_traits>
 #include <typeinfo>
+#include <utility>
+#include <vector>
 
 namespace XCSP3Core {
 
+    // Objects are allocated by moving a pointer in large blocks (arena) and are all released together by clear.
+    // Only the destructors of types that need one are recorded and called. Today every pooled type needs one (nodes,
+    // entities, domains, constraints and objectives hold strings or vectors), so clear and rewind call a destructor
+    // by object: they are O(objects). Only the release of the memory is O(blocks).
     template<typename Data>
     struct Pool {
-        std::vector<std::unique_ptr<Data>> pool_;
+        static const size_t BLOCK_SIZE = 64 * 1024;
+
+        std::vector<char*> blocks_;
+        char* current_;   // next free byte in the last block
+        char* end_;       // end of the last block
+        size_t size_;     // number of living objects
+        bool report_;     // print the number of objects freed when the pool is destroyed
+
+        typedef void (*Destructor)(void*);
+        std::vector<std::pair<void*, Destructor>> destructors_;
+
+        // If not null, objects made by the current thread are kept there, until adopt is called by the owner of the pool
+        static thread_local Pool* staging;
+
+        explicit Pool(bool report = true) : current_(nullptr), end_(nullptr), size_(0), report_(report) {}
+
+        Pool(const Pool&) = delete;
+        Pool& operator=(const Pool&) = delete;
 
         template <typename T, typename... U>
         T* make(U&&... us) {
-            pool_.emplace_back(new T(std::forward<U>(us)...));
-            return static_cast<T*>(pool_.back().get());
+            static_assert(std::is_base_of<Data, T>::value, "T must be a Data");
+            if (staging != nullptr && staging != this)
+                return staging->template make<T>(std::forward<U>(us)...);
+            T* object = new (allocate(sizeof(T), alignof(T))) T(std::forward<U>(us)...);
+            if (std::is_trivially_destructible<T>::value == false)
+                destructors_.emplace_back(object, &destroy<T>);
+            size_++;
+            return object;
+        }
+
+        // Take all objects of another pool (used to merge the pools of worker threads)
+        void adopt(Pool& other) {
+            destructors_.insert(destructors_.end(), other.destructors_.begin(), other.destructors_.end());
+            // Keep our last block as the current one
+            blocks_.insert(blocks_.empty() ? blocks_.end() : blocks_.end() - 1, other.blocks_.begin(), other.blocks_.end());
+            size_ += other.size_;
+            other.destructors_.clear();
+            other.blocks_.clear();
+            other.current_ = other.end_ = nullptr;
+            other.size_ = 0;
+        }
+
+        size_t size() const { return size_; }
+
+        // The state of the pool at some point, rewind releases all objects made since then
+        struct Mark {
+            size_t blocks;
+            char* block; // the current block
+            char* current;
+            char* end;
+            size_t destructors;
+            size_t size;
+        };
+
+        Mark mark() const {
+            Mark m = {blocks_.size(), blocks_.empty() ? nullptr : blocks_.back(), current_, end_, destructors_.size(), size_};
+            return m;
+        }
+
+        void rewind(const Mark& m) {
+            for (size_t i = destructors_.size(); i > m.destructors; i--)
+                destructors_[i - 1].second(destructors_[i - 1].first);
+            destructors_.resize(m.destructors);
+            // Blocks are only added after the current one (or just before it by adopt)
+            size_t first = m.blocks == 0 ? 0 : m.blocks - 1;
+            for (size_t i = first; i < blocks_.size(); i++)
+                if (blocks_[i] != m.block)
+                    ::operator delete(blocks_[i]);
+            blocks_.resize(first);
+            if (m.block != nullptr)
+                blocks_.push_back(m.block);
+            current_ = m.current;
+            end_ = m.end;
+            size_ = m.size;
         }
 
         ~Pool() {
-            std::cout << typeid(Data).name() << " : " << pool_.size() << " freed from pool" << std::endl;
+            if (report_)
+                std::cout << typeid(Data).name() << " : " << size_ << " freed from pool" << std::endl;
+            clear();
         }
 
         void clear() {
-            pool_.clear();
+            for (std::pair<void*, Destructor>& d : destructors_)
+                d.second(d.first);
+            destructors_.clear();
+            for (char* block : blocks_)
+                ::operator delete(block);
+            blocks_.clear();
+            current_ = end_ = nullptr;
+            size_ = 0;
+        }
+
+        // Same as clear, but the last block is kept (if it has the usual size) for the next objects
+        void reset() {
+            char* last = nullptr;
+            if (blocks_.empty() == false && static_cast<size_t>(end_ - blocks_.back()) == BLOCK_SIZE) {
+                last = blocks_.back();
+                blocks_.pop_back();
+            }
+            clear();
+            if (last != nullptr) {
+                blocks_.push_back(last);
+                current_ = last;
+                end_ = last + BLOCK_SIZE;
+            }
+        }
+
+    private:
+        template <typename T>
+        static void destroy(void* object) {
+            static_cast<T*>(object)->~T();
+        }
+
+        void* allocate(size_t size, size_t alignment) {
+            size_t padding = (alignment - reinterpret_cast<uintptr_t>(current_) % alignment) % alignment;
+            if (current_ == nullptr || static_cast<size_t>(end_ - current_) < padding + size) {
+                // operator new is aligned for any type, and memory accounting that replaces it sees the blocks
+                size_t capacity = size > BLOCK_SIZE ? size : BLOCK_SIZE;
+                char* block = static_cast<char*>(::operator new(capacity));
+                blocks_.push_back(block);
+                current_ = block;
+                end_ = block + capacity;
+                padding = 0;
+            }
+            void* result = current_ + padding;
+            current_ += padding + size;
+            return result;
         }
     };
 
+    template<typename Data>
+    thread_local Pool<Data>* Pool<Data>::staging = nullptr;
+
+    // Each different string is kept once (interning), it lives until the table is cleared or rewound
+    class StringTable {
+        std::deque<std::string> strings;       // in the order of interning, addresses are stable
+        std::vector<const std::string*> table; // open addressing with linear probing, the size is a power of 2
+
+        size_t slotOf(const std::string& s) const; // the slot of s, or the empty slot where it goes
+
+    public:
+        const std::string* intern(const std::string& s);
+
+        size_t size() const { return strings.size(); }
+
+        size_t mark() const { return strings.size(); }
+        void rewind(size_t m); // release the strings interned since the mark
+        void clear();
+    };
+
     class XEntity;
     class XIntegerEntity;
     class XDomain;
     class XConstraint;
     class XObjective;
     class Node;
+    struct XGroupData;
 
+    // The pools of a parse. Each XCSP3CoreParser owns one, so instances can be parsed by several threads at the same time
     struct DataPool {
-        static Pool<XEntity> EntityPool;
-        static Pool<XIntegerEntity> IntegerEntityPool;
-        static Pool<XDomain> DomainPool;
-        static Pool<XConstraint> ConstraintPool;
-        static Pool<XObjective> ObjectivePool;
-        static Pool<Node> NodePool;
-
-        static void clear();
+        StringTable StringPool; // ids and classes of constraints (XString), released after the objects
+        Pool<XEntity> EntityPool;
+        Pool<XIntegerEntity> IntegerEntityPool;
+        Pool<XDomain> DomainPool;
+        Pool<XConstraint> ConstraintPool;
+        Pool<XObjective> ObjectivePool;
+        Pool<Node> NodePool;
+        XGroupData* groupData;
+
+        explicit DataPool(bool report = true);
+        ~DataPool();
+
+        DataPool(const DataPool&) = delete;
+        DataPool& operator=(const DataPool&) = delete;
+
+        void clear();
+        void reset(); // clear, but keep a block in each pool
+
+        struct Mark {
+            Pool<XEntity>::Mark entities;
+            Pool<XIntegerEntity>::Mark integerEntities;
+            Pool<XDomain>::Mark domains;
+            Pool<XConstraint>::Mark constraints;
+            Pool<XObjective>::Mark objectives;
+            Pool<Node>::Mark nodes;
+            size_t strings;
+        };
+
+        Mark mark() const;
+        void rewind(const Mark& m); // release all objects made since the mark
+
+        // The pools of the parse in progress in the current thread, a process-wide one outside a parse
+        static DataPool& current() {
+            return inUse != nullptr ? *inUse : global();
+        }
+
+        // The string in the StringPool of the parse in progress, or in the process-wide one (with a lock) outside a parse
+        static const std::string* intern(const std::string& s);
+
+        // The pools used by the current thread while it exists
+        class Use {
+            DataPool* previous;
+
+        public:
+            explicit Use(DataPool& pool) : previous(inUse) { inUse = &pool; }
+            ~Use() { inUse = previous; }
+        };
+
+    private:
+        static thread_local DataPool* inUse;
+        static DataPool& global();
+    };
+
+    // A string interned in the StringPool of the current DataPool: a pointer, copied without allocation.
+    // It is converted on demand to the const std::string& expected by callbacks, and compared or concatenated as a std::string.
+    // Interning saves memory when strings repeat (classes, empty ids), but costs a slot of the table by string:
+    // with only distinct ids, the parse of a large instance uses a little more memory than with std::string (about 5%).
+    class XString {
+        const std::string* s;
+
+    public:
+        XString();
+        // Interned in the StringPool of the parse in progress, by the thread which parses. Outside a parse, the string
+        // is interned in a process-wide table (locked) and lives until the end of the process.
+        explicit XString(const std::string& str);
+        explicit XString(const char* str);
+
+        const std::string& str() const { return *s; }
+        operator const std::string&() const { return *s; }
+
+        bool empty() const { return s->empty(); }
+        size_t size() const { return s->size(); }
+        const char* c_str() const { return s->c_str(); }
+
+        friend std::ostream& operator<<(std::ostream& f, const XString& x) { return f << *x.s; }
     };
 
+    // The operators of std::string are templates, they do not see the conversion of XString
+    inline bool operator==(const XString& a, const XString& b) { return a.str() == b.str(); }
+    inline bool operator==(const XString& a, const std::string& b) { return a.str() == b; }
+    inline bool operator==(const std::string& a, const XString& b) { return a == b.str(); }
+    inline bool operator==(const XString& a, const char* b) { return a.str() == b; }
+    inline bool operator==(const char* a, const XString& b) { return a == b.str(); }
+    inline bool operator!=(const XString& a, const XString& b) { return a.str() != b.str(); }
+    inline bool operator!=(const XString& a, const std::string& b) { return a.str() != b; }
+    inline bool operator!=(const std::string& a, const XString& b) { return a != b.str(); }
+    inline bool operator!=(const XString& a, const char* b) { return a.str() != b; }
+    inline bool operator!=(const char* a, const XString& b) { return a != b.str(); }
+    inline bool operator<(const XString& a, const XString& b) { return a.str() < b.str(); }
+    inline std::string operator+(const XString& a, const std::string& b) { return a.str() + b; }
+    inline std::string operator+(const std::string& a, const XString& b) { return a + b.str(); }
+    inline std::string operator+(const XString& a, const char* b) { return a.str() + b; }
+    inline std::string operator+(const char* a, const XString& b) { return a + b.str(); }
+
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -27,6 +27,7 @@
 #define TREE_H
 
 #include "XCSP3TreeNode.h"
+#include "XCSP3Variable.h"
 #include <assert.h>
 #include <cmath>
 #include <iostream>
@@ -37,20 +38,21 @@ namespace XCSP3Core {
     class Tree {
     protected:
         std::string expr;
+        std::map<std::string, XEntity*>* symbols; // used to bind variable nodes to their XVariable, if not null
 
-        void createOperator(std::string currentElement, std::vector<NodeOperator*>& stack, std::vector<Node*>& params);
-        void closeOperator(std::vector<NodeOperator*>& stack, std::vector<Node*>& params);
-        void createBasicParameter(std::string currentElement, std::vector<NodeOperator*>& stack, std::vector<Node*>& params);
+        void createOperator(std::string currentElement, std::vector<Expr>& stack, std::vector<Node*>& params);
+        void closeOperator(std::vector<Expr>& stack, std::vector<Node*>& params);
+        void createBasicParameter(std::string currentElement, std::vector<Expr>& stack, std::vector<Node*>& params);
 
     public:
         Node* root;
         std::vector<std::string> listOfVariables;
 
-        Tree(std::string e) : expr(e) {
+        Tree(std::string e, std::map<std::string, XEntity*>* s = nullptr) : expr(e), symbols(s) {
             root = fromStringToTree(expr);
         }
 
-        Tree(Node* r) : root(r) {}
+        Tree(Node* r) : symbols(nullptr), root(r) {}
 
         Node* fromStringToTree(std::string);
 
@@ -66,8 +68,16 @@ namespace XCSP3Core {
             return root->toString();
         }
 
+        // Replace the content of the buffer by the expression (the buffer can be reused between trees)
+        void toString(std::string& buffer) {
+            buffer.clear();
+            root->toString(buffer);
+        }
+
         void prefixe() {
-            std::cout << root->toString();
+            std::string buffer;
+            toString(buffer);
+            std::cout << buffer;
         }
 
         void canonize() {
@@ -29,14 +29,19 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstdio>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 namespace XCSP3Core {
 
+    class XVariable;
+
     enum class Expr {
         UNDEF,
         NEG,
@@ -128,13 +133,22 @@ namespace XCSP3Core {
 
         std::vector<Node*> parameters; // Useless for constant and variables, but avoid many casts!
 
-        Node(Expr o) : type(o) {}
+        size_t hash; // Set only for nodes shared by a NodeFactory
+
+        Node(Expr o) : type(o), hash(0) {}
 
         virtual int evaluate(std::map<std::string, int>& tuple) = 0;
 
         virtual Node* canonize() = 0;
 
-        virtual std::string toString() = 0;
+        // Write the expression at the end of the buffer, in one pass
+        virtual void toString(std::string& buffer) = 0;
+
+        std::string toString() {
+            std::string buffer;
+            toString(buffer);
+            return buffer;
+        }
 
         static bool areSimilar(Node* canonized, Node* pattern, std::vector<Expr>& operators, std::vector<int>& constants, std::vector<std::string>& variables);
     };
@@ -157,8 +171,12 @@ namespace XCSP3Core {
             return this;
         }
 
-        std::string toString() override {
-            return std::to_string(val);
+        using Node::toString;
+
+        void toString(std::string& buffer) override {
+            char tmp[16];
+            int len = snprintf(tmp, sizeof(tmp), "%d", val);
+            buffer.append(tmp, len);
         }
     };
 
@@ -167,9 +185,11 @@ namespace XCSP3Core {
     class NodeVariable : public Node {
 
     public:
-        std::string var;
+        std::string var;     // the name, used for printing
+        XVariable* variable; // nullptr if the name is not a variable of the instance (patterns...)
+        int index;           // dense index of the variable (see XVariable::index), -1 if variable is nullptr
 
-        NodeVariable(std::string v) : Node(Expr::VAR), var(v) {}
+        NodeVariable(std::string v, XVariable* x = nullptr);
 
         int evaluate(std::map<std::string, int>& tuple) override {
             return tuple[var];
@@ -179,8 +199,10 @@ namespace XCSP3Core {
             return this;
         }
 
-        std::string toString() override {
-            return var;
+        using Node::toString;
+
+        void toString(std::string& buffer) override {
+            buffer += var;
         }
     };
 
@@ -202,15 +224,17 @@ namespace XCSP3Core {
             return this;
         }
 
-        std::string toString() override {
-            std::string tmp = op + "(";
+        using Node::toString;
+
+        void toString(std::string& buffer) override {
+            buffer += op;
+            buffer += '(';
             for (unsigned int i = 0; i < parameters.size(); i++) {
                 if (i != 0)
-                    tmp = tmp + ",";
-                tmp = tmp + parameters[i]->toString();
+                    buffer += ',';
+                parameters[i]->toString(buffer);
             }
-            tmp = tmp + ")";
-            return tmp;
+            buffer += ')';
         }
 
         Node* canonize() override;
@@ -562,5 +586,58 @@ namespace XCSP3Core {
         }
     };
 
+    //-------------------------------------
+    // Hash-consing of nodes: structurally equal nodes are created once and shared.
+    // Shared nodes must not be modified.
+    //-------------------------------------
+
+    class NodeFactory {
+        std::unordered_multimap<size_t, Node*> nodes;
+
+        Node* find(size_t h, Expr type, int val, const std::string* var, XVariable* x, std::vector<Node*>* params);
+        Node* insert(size_t h, Node* node);
+
+    public:
+        unsigned long created; // distinct nodes
+        unsigned long shared;  // nodes obtained from an equal one
+
+        static thread_local NodeFactory* current; // used by createNodeXXX functions, nullptr if nodes are not shared
+
+        NodeFactory() : created(0), shared(0) {}
+
+        Node* constant(int val);
+        Node* variable(const std::string& var, XVariable* x);
+        Node* node(Expr type, std::vector<Node*>& params);
+
+        void clear() {
+            nodes.clear();
+            created = shared = 0;
+        }
+
+        // The known nodes are released, but counters are kept
+        void forget() {
+            nodes.clear();
+        }
+
+        // Nodes created in the scope of this object are not shared (patterns that are modified after their creation)
+        class Suspend {
+            NodeFactory* saved;
+
+        public:
+            Suspend() : saved(current) {
+                current = nullptr;
+            }
+
+            ~Suspend() {
+                current = saved;
+            }
+        };
+    };
+
+    NodeOperator* createNodeOperator(Expr type); // without parameters, never shared
+    Node* createNodeConstant(int val);
+    Node* createNodeVariable(const std::string& var, XVariable* x = nullptr);
+    Node* createNodeOperator(Expr type, std::vector<Node*>& params);
+
 } // namespace XCSP3Core
 #endif //XCSP3PARSER_XCSP3TREENODE_H
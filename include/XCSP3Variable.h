@@ -38,21 +38,27 @@ namespace XCSP3Core {
         friend std::ostream& operator<<(std::ostream& f, const XInterval& ie);
     };
 
+    // The concrete class of a XEntity, tested instead of using dynamic_cast
+    // All kinds from VARIABLE are XVariable (the others are fake variables)
+    enum class EntityKind { ENTITY, ARRAY, VARIABLE, INTEGER, TREE, INTERVAL, PARAMETER };
+
     class XEntity {
     public:
         std::string id;
+        EntityKind kind;
 
         XEntity();
         XEntity(std::string lid);
         virtual ~XEntity();
 
-        virtual void fake() {} // Fake function to allow use of dynamic_cast !!
+        bool isVariable() const { return kind >= EntityKind::VARIABLE; }
     };
 
     class XVariable : public XEntity {
     public:
         std::string classes;
         XDomainInteger* domain;
+        int index; // dense index of the variable in the instance, in order of declaration (-1 for fake variables)
 
         XVariable(std::string idd, XDomainInteger* dom);
         XVariable(std::string idd, XDomainInteger* dom, std::vector<int> indexes);
@@ -68,7 +74,7 @@ namespace XCSP3Core {
     public:
         int value;
 
-        XInteger(std::string lid, int n) : XVariable(lid, NULL), value(n) {}
+        XInteger(std::string lid, int n) : XVariable(lid, NULL), value(n) { kind = EntityKind::INTEGER; }
     };
 
     /*
@@ -76,14 +82,14 @@ namespace XCSP3Core {
      */
     class XTree : public XVariable {
     public:
-        XTree(std::string lid) : XVariable(lid, NULL) {}
+        XTree(std::string lid) : XVariable(lid, NULL) { kind = EntityKind::TREE; }
     };
 
     class XEInterval : public XVariable {
     public:
         int min, max;
 
-        XEInterval(std::string lid, int mn, int mx) : XVariable(lid, NULL), min(mn), max(mx) {}
+        XEInterval(std::string lid, int mn, int mx) : XVariable(lid, NULL), min(mn), max(mx) { kind = EntityKind::INTERVAL; }
     };
 
     // Check if a XEntity is an integer
@@ -101,11 +107,17 @@ namespace XCSP3Core {
      */
     class XParameterVariable : public XVariable {
     public:
-        static int max; // Max parameter number for current group
-        int number;     // -1 if %...
+        int number; // -1 if %...
         XParameterVariable(std::string lid);
     };
 
+    // Return the parameter if the XEntity is one (%i or %...), NULL otherwise
+    inline XParameterVariable* isParameter(XEntity* xe) {
+        return xe != NULL && xe->kind == EntityKind::PARAMETER ? static_cast<XParameterVariable*>(xe) : NULL;
+    }
+
+    class XArraySlice;
+
     class XVariableArray : public XEntity {
     public:
         std::string classes;
@@ -133,18 +145,60 @@ namespace XCSP3Core {
          */
         void indexesFor(int flatIndex, std::vector<int>& indexes);
 
-        int flatIndexFor(std::vector<int> indexes);
+        int flatIndexFor(const std::vector<int>& indexes);
 
         bool incrementIndexes(std::vector<int>& indexes, std::vector<XIntegerEntity*>& ranges);
 
         /** Returns the list of variables that match the specified compact form. For example, for x[1..3], the list will contain x[1] x[2] and x[3]. */
-        void getVarsFor(std::vector<XVariable*>& list, std::string compactForm, std::vector<int>* flatIndexes = NULL, bool storeIndexes = false);
+        void getVarsFor(std::vector<XVariable*>& list, const std::string& compactForm, std::vector<int>* flatIndexes = NULL, bool storeIndexes = false);
 
         /** 
          * Builds a variable with the specified domain 
          *  for each unoccupied cell of the flat array. 
          */
         void buildVarsWith(XDomainInteger* domain);
+
+        /** Gives the cells that match the specified compact form (ex: x[][2..5]) as a slice, without listing them. */
+        void sliceFor(const std::string& compactForm, XArraySlice& slice);
+    };
+
+    /**
+     * The cells of an array selected by a compact form such as x[][2..5]: one range of indexes by dimension.
+     * Cells are visited lazily, in the order of getVarsFor, with the iterator.
+     */
+    class XArraySlice {
+    public:
+        XVariableArray* array;         // nullptr if there is no slice
+        std::vector<XInterval> ranges; // for each dimension, the indexes of the slice
+        std::vector<int> strides;      // for each dimension, the distance between two consecutive cells in the flat array
+
+        XArraySlice() : array(nullptr) {}
+
+        // Number of cells (some cells of an array may have no variable)
+        size_t size() const;
+
+        class iterator {
+            const XArraySlice* slice;
+            std::vector<int> indexes_;
+            int flat; // -1 at the end
+
+        public:
+            iterator(const XArraySlice* s, bool end);
+
+            XVariable* operator*() const { return slice->array->variables[flat]; } // nullptr if the cell has no variable
+            iterator& operator++();
+            bool operator==(const iterator& other) const { return flat == other.flat; }
+            bool operator!=(const iterator& other) const { return flat != other.flat; }
+
+            int flatIndex() const { return flat; }                       // index of the cell in the flat array
+            const std::vector<int>& indexes() const { return indexes_; } // indexes of the cell in each dimension
+        };
+
+        iterator begin() const { return iterator(this, array == nullptr); }
+        iterator end() const { return iterator(this, true); }
+
+        // Append the variables of the slice to the list (cells without variable are skipped)
+        void getVars(std::vector<XVariable*>& list) const;
     };
 } // namespace XCSP3Core
 
@@ -27,6 +27,7 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstddef>
 #include <cwctype>
 #include <functional>
 #include <locale>
@@ -55,6 +56,28 @@ namespace XCSP3Core {
     // trim from both ends
     std::string& trim(std::string& s);
 
+    // Read-only view on contiguous elements (a vector, a part of it...), given to callbacks without copy.
+    // It is valid only during the call that receives it.
+    template <typename T>
+    class XSpan {
+        const T* data_;
+        size_t size_;
+
+    public:
+        XSpan() : data_(nullptr), size_(0) {}
+        XSpan(const T* data, size_t size) : data_(data), size_(size) {}
+        XSpan(const std::vector<T>& v) : data_(v.data()), size_(v.size()) {}
+
+        const T* begin() const { return data_; }
+        const T* end() const { return data_ + size_; }
+        const T* data() const { return data_; }
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        const T& operator[](size_t i) const { return data_[i]; }
+
+        std::vector<T> toVector() const { return std::vector<T>(data_, data_ + size_); }
+    };
+
 } // namespace XCSP3Core
 
 #endif /* UTILS_H */
@@ -77,6 +77,12 @@ namespace XCSP3Core {
         std::vector<XDomainInteger*> allDomains;
         std::vector<XConstraint*> constraints;
         std::unique_ptr<XCSP3Manager> manager;
+        int nbVariables; // used to give a dense index to variables
+
+        void declareVariable(XVariable* x) {
+            x->index = nbVariables++;
+            variablesList[x->id] = x;
+        }
 
         // stack of operands to construct list, dictionaries, predicate
         // parameters and so on
@@ -204,10 +210,25 @@ namespace XCSP3Core {
         std::string start, final;             // used in regular constraint
         std::vector<XTransition> transitions; // used in regular and mdd constraints
         int nbParameters;
+        int maxParameter; // the greatest i of %i in the current group, -1 if none
         bool closed;
 
         bool keepIntervals;
 
+        // With nativeArraySlices: a list that is exactly one compact form is kept as a slice (not expanded) in lists[0]
+        bool sliceAllowed;
+        XArraySlice slice;
+
+        // Give the constraint with the slice of its list if there is one and the constraint has no other list (alone)
+        // Return true if the callback handles it, otherwise the slice is expanded in lists[0]
+        bool postSlice(ConstraintType type, XConstraint* constraint, bool alone);
+
+        // > 0 while the elements of a discarded subtree are skipped: only the depth is followed until its end tag
+        int skipDepth;
+        // True if the element and its subtree are skipped: a constraint (or block, group, slide) with a discarded class,
+        // or a section the callback is not interested in (skipAnnotations, skipObjectives)
+        bool discardedSubtree(const UTF8String& name, const AttributeList& attributes);
+
         void registerTagAction(TagActionList& tagList, TagAction* action) {
             tagList[action->getTagName()].reset(action);
         }
@@ -681,15 +702,15 @@ namespace XCSP3Core {
             virtual void endTag() {
                 this->parser->condition = trim(this->parser->condition);
 
-                std::regex const rglt(R"(\(.*(le|lt|ge|gt|in|eq|ne),%([0-9]+)\).*)");
-                std::smatch match;
-                std::regex_match(this->parser->condition, match, rglt);
-
-                if (match.size() != 3)
+                XCondition xc;
+                if (XInitialCondition::parseCondition(this->parser->condition, xc) == false || xc.operandType != OperandType::VARIABLE)
+                    return;
+                // (op,%i): the parameter is used
+                if (xc.var.size() < 2 || xc.var[0] != '%' || xc.var.find_first_not_of("0123456789", 1) != std::string::npos)
                     return;
-                int tmp = std::stoi(match[2].str());
-                if (XParameterVariable::max < tmp)
-                    XParameterVariable::max = tmp;
+                int tmp = std::stoi(xc.var.substr(1));
+                if (this->parser->maxParameter < tmp)
+                    this->parser->maxParameter = tmp;
             }
         };
 
@@ -910,6 +931,9 @@ namespace XCSP3Core {
         XMLParser(XCSP3CoreCallbacksBase* cb);
         ~XMLParser();
 
+        // Prepare a new parse: stacks and lists are emptied, tag actions and capacities are kept
+        void reset();
+
         /**
          * get the parent tag action that is n levels higher in the current
          * branch of the XML parse tree
@@ -943,6 +967,9 @@ namespace XCSP3Core {
             stateStack.clear();
         }
 
+        // True if the current tag is a constraint (or group, slide) whose objects are released after its callbacks
+        bool releasableConstraint();
+
         // text which is left for the next call to characters() because it
         // may not be a complete token
         UTF8String textLeft;
@@ -60,6 +60,10 @@ namespace XCSP3Core {
         void beginGroup(const std::string& id) override;
         void endGroup() override;
 
+        bool buildConstraintGroup(const std::string& id, ConstraintType type, XConstraint* constraint, std::vector<XVariable*>& arguments, int arity) override;
+        bool buildConstraintGroup(const std::string& id, Tree* tree, std::vector<XVariable*>& arguments, int arity) override;
+        bool buildConstraintSlice(const std::string& id, ConstraintType type, XConstraint* constraint, XArraySlice& slice) override;
+
         void beginBlock(const std::string& classes) override;
         void endBlock() override;
 
@@ -299,6 +303,29 @@ void XCSP3PrintCallbacks::endGroup() {
     std::cout << "   end group of constraint" << std::endl;
 }
 
+bool XCSP3PrintCallbacks::buildConstraintGroup(const std::string&, ConstraintType, XConstraint*, std::vector<XVariable*>&, int) {
+    return false; // the constraints are unfolded
+}
+
+bool XCSP3PrintCallbacks::buildConstraintGroup(const std::string& id, Tree* tree, std::vector<XVariable*>& arguments, int arity) {
+    std::cout << "\n    group " << id << " of intension constraints: " << tree->toString() << std::endl;
+    for(size_t i = 0; i < arguments.size(); i += arity) {
+        std::cout << "        ";
+        for(int j = 0; j < arity; j++)
+            std::cout << arguments[i + j]->id << " ";
+        std::cout << std::endl;
+    }
+    return true;
+}
+
+bool XCSP3PrintCallbacks::buildConstraintSlice(const std::string& id, ConstraintType, XConstraint*, XArraySlice& slice) {
+    std::cout << "\n    slice of " << slice.array->id << " in constraint " << id << ":";
+    for (const XInterval& range : slice.ranges)
+        std::cout << " [" << range.min << ".." << range.max << "]";
+    std::cout << std::endl;
+    return false; // the list is expanded
+}
+
 void XCSP3PrintCallbacks::beginBlock(const std::string& classes) {
     std::cout << "   start block of constraint classes = " << classes << std::endl;
 }
@@ -29,733 +29,695 @@
 #include "XCSP3CoreCallbacks.h"
 #include "XCSP3Variable.h"
 #include <XCSP3Tree.h>
+#include <map>
 /**
- * This is an example that prints useful informations of a XCSP3 instance.
- * You need to create your own class and to override functions of the callback.
- * We suggest to make a map between XVariable and your own variables in order to
- * facilitate the constructions of constraints.
- *
- * see main.cc to show declaration of the parser
+ * This is an example that counts the variables, constraints (by kind), tuples and tree nodes of a XCSP3 instance.
+ * Nothing is printed: fields are read once the instance is parsed (see batch.cc).
  *
  */
 
 namespace XCSP3Core {
 
-    class XCSP3SummaryCallbacks : public XCSP3CoreCallbacks {
+    class XCSP3SummaryCallbacks : public XCSP3CoreCallbacksBase {
     public:
-        int nbv, nbc;
-        string minmax, type;
+        std::string type;                                       // CSP or COP
+        unsigned long nbVariables, nbConstraints, nbObjectives;
+        unsigned long nbTuples;                                 // tuples of extensional constraints
+        unsigned long nbNodes;                                  // nodes of the trees of constraints and objectives
+        std::map<std::string, unsigned long> constraintsByType; // number of constraints of each kind (sum, allDifferent...)
 
         XCSP3SummaryCallbacks();
 
-        virtual void beginInstance(InstanceType type) override;
-
-        virtual void endInstance() override;
-
-        virtual void beginVariables() override;
-
-        virtual void endVariables() override;
-
-        virtual void beginVariableArray(string id) override;
-
-        virtual void endVariableArray() override;
-
-        virtual void beginConstraints() override;
-
-        virtual void endConstraints() override;
-
-        virtual void beginGroup(string id) override;
-
-        virtual void endGroup() override;
-
-        virtual void beginBlock(string classes) override;
+        void beginInstance(InstanceType type) override;
+        void endInstance() override;
 
-        virtual void endBlock() override;
+        void beginVariables() override;
+        void endVariables() override;
 
-        virtual void beginSlide(string id, bool circular) override;
+        void beginVariableArray(const std::string& id) override;
+        void endVariableArray() override;
 
-        virtual void endSlide() override;
+        void beginConstraints() override;
+        void endConstraints() override;
 
-        virtual void beginObjectives() override;
+        void beginGroup(const std::string& id) override;
+        void endGroup() override;
 
-        virtual void endObjectives() override;
+        bool buildConstraintGroup(const std::string& id, ConstraintType type, XConstraint* constraint, std::vector<XVariable*>& arguments, int arity) override;
+        bool buildConstraintGroup(const std::string& id, Tree* tree, std::vector<XVariable*>& arguments, int arity) override;
+        bool buildConstraintSlice(const std::string& id, ConstraintType type, XConstraint* constraint, XArraySlice& slice) override;
 
-        virtual void beginAnnotations() override;
+        void beginBlock(const std::string& classes) override;
+        void endBlock() override;
 
-        virtual void endAnnotations() override;
+        void beginSlide(const std::string& id, bool circular) override;
+        void endSlide() override;
 
-        virtual void buildVariableInteger(string id, int minValue, int maxValue) override;
+        void beginObjectives() override;
+        void endObjectives() override;
 
-        virtual void buildVariableInteger(string id, vector<int>& values) override;
+        void beginAnnotations() override;
+        void endAnnotations() override;
 
-        virtual void buildConstraintExtension(string id, vector<XVariable*> list, vector<vector<int>>& tuples, bool support, bool hasStar) override;
+        void buildVariableInteger(const std::string& id, int minValue, int maxValue) override;
+        void buildVariableInteger(const std::string& id, std::vector<int>& values) override;
 
-        virtual void buildConstraintExtension(string id, XVariable* variable, vector<int>& tuples, bool support, bool hasStar) override;
+        void buildAnnotationDecision(std::vector<XVariable*>& list) override;
 
-        virtual void buildConstraintExtensionAs(string id, vector<XVariable*> list, bool support, bool hasStar) override;
+        void buildConstraintTrue(const std::string& id) override;
+        void buildConstraintFalse(const std::string& id) override;
 
-        virtual void buildConstraintIntension(string id, string expr) override;
+        void buildConstraintExtension(const std::string& id, std::vector<XVariable*> list, std::vector<std::vector<int>>& tuples, bool support, bool hasStar) override;
+        void buildConstraintExtension(const std::string& id, XVariable* variable, std::vector<int>& tuples, bool support, bool hasStar) override;
 
-        virtual void buildConstraintIntension(string id, Tree* tree) override;
+        void buildConstraintExtensionAs(const std::string& id, std::vector<XVariable*> list, bool support, bool hasStar) override;
 
-        virtual void buildConstraintPrimitive(string id, OrderType op, XVariable* x, int k, XVariable* y) override;
+        // The scopes of tables are not copied
+        void buildConstraintExtensionSpan(const std::string& id, XSpan<XVariable*> list, std::vector<std::vector<int>>& tuples, bool support, bool hasStar) override;
+        void buildConstraintExtensionAsSpan(const std::string& id, XSpan<XVariable*> list, bool support, bool hasStar) override;
 
-        virtual void buildConstraintPrimitive(string id, OrderType op, XVariable* x, int k) override;
+        void buildConstraintIntension(const std::string& id, std::string expr) override;
+        void buildConstraintIntension(const std::string& id, Tree* tree) override;
 
-        virtual void buildConstraintPrimitive(string id, XVariable* x, bool in, int min, int max) override;
+        void buildConstraintPrimitive(const std::string& id, OrderType op, XVariable* x, int k, XVariable* y) override;
+        void buildConstraintPrimitive(const std::string& id, OrderType op, XVariable* x, int k) override;
+        void buildConstraintPrimitive(const std::string& id, XVariable* x, bool in, int min, int max) override;
 
-        virtual void buildConstraintRegular(string id, vector<XVariable*>& list, string st, vector<string>& final, vector<XTransition>& transitions) override;
+        void buildConstraintRegular(const std::string& id, std::vector<XVariable*>& list, std::string st, std::vector<std::string>& final, std::vector<XTransition>& transitions) override;
 
-        virtual void buildConstraintMDD(string id, vector<XVariable*>& list, vector<XTransition>& transitions) override;
+        void buildConstraintMDD(const std::string& id, std::vector<XVariable*>& list, std::vector<XTransition>& transitions) override;
 
-        virtual void buildConstraintAlldifferent(string id, vector<XVariable*>& list) override;
+        void buildConstraintAlldifferent(const std::string& id, std::vector<XVariable*>& list) override;
+        void buildConstraintAlldifferentExcept(const std::string& id, std::vector<XVariable*>& list, std::vector<int>& except) override;
+        void buildConstraintAlldifferent(const std::string& id, std::vector<Tree*>& list) override;
+        void buildConstraintAlldifferentList(const std::string& id, std::vector<std::vector<XVariable*>>& lists) override;
+        void buildConstraintAlldifferentMatrix(const std::string& id, std::vector<std::vector<XVariable*>>& matrix) override;
 
-        virtual void buildConstraintAlldifferentExcept(string id, vector<XVariable*>& list, vector<int>& except) override;
+        void buildConstraintAllEqual(const std::string& id, std::vector<XVariable*>& list) override;
 
-        virtual void buildConstraintAlldifferent(string id, vector<Tree*>& list) override;
+        void buildConstraintNotAllEqual(const std::string& id, std::vector<XVariable*>& list) override;
 
-        virtual void buildConstraintAlldifferentList(string id, vector<vector<XVariable*>>& lists) override;
+        void buildConstraintOrdered(const std::string& id, std::vector<XVariable*>& list, OrderType order) override;
+        void buildConstraintOrdered(const std::string& id, std::vector<XVariable*>& list, std::vector<int>& lengths, OrderType order) override;
 
-        virtual void buildConstraintAlldifferentMatrix(string id, vector<vector<XVariable*>>& matrix) override;
+        void buildConstraintLex(const std::string& id, std::vector<std::vector<XVariable*>>& lists, OrderType order) override;
+        void buildConstraintLexMatrix(const std::string& id, std::vector<std::vector<XVariable*>>& matrix, OrderType order) override;
 
-        virtual void buildConstraintAllEqual(string id, vector<XVariable*>& list) override;
+        void buildConstraintSum(const std::string& id, std::vector<XVariable*>& list, std::vector<int>& coeffs, XCondition& cond) override;
+        void buildConstraintSum(const std::string& id, std::vector<XVariable*>& list, XCondition& cond) override;
+        void buildConstraintSum(const std::string& id, std::vector<XVariable*>& list, std::vector<XVariable*>& coeffs, XCondition& cond) override;
+        void buildConstraintSum(const std::string& id, std::vector<Tree*>& list, std::vector<int>& coeffs, XCondition& cond) override;
+        void buildConstraintSum(const std::string& id, std::vector<Tree*>& list, XCondition& cond) override;
 
-        virtual void buildConstraintNotAllEqual(string id, vector<XVariable*>& list) override;
+        void buildConstraintMult(const std::string& id, XVariable* x, XVariable* y, XVariable* z) override;
 
-        virtual void buildConstraintOrdered(string id, vector<XVariable*>& list, OrderType order) override;
+        void buildConstraintAtMost(const std::string& id, std::vector<XVariable*>& list, int value, int k) override;
+        void buildConstraintAtLeast(const std::string& id, std::vector<XVariable*>& list, int value, int k) override;
+        void buildConstraintExactlyK(const std::string& id, std::vector<XVariable*>& list, int value, int k) override;
+        void buildConstraintAmong(const std::string& id, std::vector<XVariable*>& list, std::vector<int>& values, int k) override;
+        void buildConstraintExactlyVariable(const std::string& id, std::vector<XVariable*>& list, int value, XVariable* x) override;
 
-        virtual void buildConstraintOrdered(string id, vector<XVariable*>& list, vector<int>& lengths, OrderType order) override;
+        void buildConstraintCount(const std::string& id, std::vector<XVariable*>& list, std::vector<int>& values, XCondition& xc) override;
+        void buildConstraintCount(const std::string& id, std::vector<XVariable*>& list, std::vector<XVariable*>& values, XCondition& xc) override;
 
-        virtual void buildConstraintLex(string id, vector<vector<XVariable*>>& lists, OrderType order) override;
+        void buildConstraintNValues(const std::string& id, std::vector<XVariable*>& list, std::vector<int>& except, XCondition& xc) override;
+        void buildConstraintNValues(const std::string& id, std::vector<XVariable*>& list, XCondition& xc) override;
 
-        virtual void buildConstraintLexMatrix(string id, vector<vector<XVariable*>>& matrix, OrderType order) override;
+        void buildConstraintCardinality(const std::string& id, std::vector<XVariable*>& list, std::vector<int> values, std::vector<int>& occurs, bool closed) override;
+        void buildConstraintCardinality(const std::string& id, std::vector<XVariable*>& list, std::vector<int> values, std::vector<XVariable*>& occurs, bool closed) override;
+        void buildConstraintCardinality(const std::string& id, std::vector<XVariable*>& list, std::vector<int> values, std::vector<XInterval>& occurs, bool closed) override;
+        void buildConstraintCardinality(const std::string& id, std::vector<XVariable*>& list, std::vector<XVariable*> values, std::vector<int>& occurs, bool closed) override;
+        void buildConstraintCardinality(const std::string& id, std::vector<XVariable*>& list, std::vector<XVariable*> values, std::vector<XVariable*>& occurs, bool closed) override;
+        void buildConstraintCardinality(const std::string& id, std::vector<XVariable*>& list, std::vector<XVariable*> values, std::vector<XInterval>& occurs, bool closed) override;
 
-        virtual void buildConstraintSum(string id, vector<XVariable*>& list, vector<int>& coeffs, XCondition& cond) override;
+        void buildConstraintMinimum(const std::string& id, std::vector<XVariable*>& list, XCondition& xc) override;
+        void buildConstraintMinimum(const std::string& id, std::vector<XVariable*>& list, XVariable* index, int startIndex, RankType rank, XCondition& xc) override;
+        void buildConstraintMinimum(const std::string& id, std::vector<Tree*>& list, XCondition& xc) override;
 
-        virtual void buildConstraintSum(string id, vector<XVariable*>& list, XCondition& cond) override;
+        void buildConstraintMaximum(const std::string& id, std::vector<XVariable*>& list, XCondition& xc) override;
+        void buildConstraintMaximum(const std::string& id, std::vector<XVariable*>& list, XVariable* index, int startIndex, RankType rank, XCondition& xc) override;
+        void buildConstraintMaximum(const std::string& id, std::vector<Tree*>& list, XCondition& xc) override;
 
-        virtual void buildConstraintSum(string id, vector<XVariable*>& list, vector<XVariable*>& coeffs, XCondition& cond) override;
+        void buildConstraintElement(const std::string& id, std::vector<XVariable*>& list, int value) override;
+        void buildConstraintElement(const std::string& id, std::vector<XVariable*>& list, XVariable* value) override;
+        void buildConstraintElement(const std::string& id, std::vector<XVariable*>& list, int startIndex, XVariable* index, RankType rank, int value) override;
+        void buildConstraintElement(const std::string& id, std::vector<XVariable*>& list, int startIndex, XVariable* index, RankType rank, XVariable* value) override;
+        void buildConstraintElement(const std::string& id, std::vector<int>& list, int startIndex, XVariable* index, RankType rank, XVariable* value) override;
+        void buildConstraintElement(const std::string& id, std::vector<std::vector<int>>& matrix, int startRowIndex, XVariable* rowIndex, int startColIndex, XVariable* colIndex, XVariable* value) override;
+        void buildConstraintElement(const std::string& id, std::vector<std::vector<XVariable*>>& matrix, int startRowIndex, XVariable* rowIndex, int startColIndex, XVariable* colIndex, XVariable* value) override;
+        void buildConstraintElement(const std::string& id, std::vector<std::vector<XVariable*>>& matrix, int startRowIndex, XVariable* rowIndex, int startColIndex, XVariable* colIndex, int value) override;
 
-        virtual void buildConstraintSum(string id, vector<Tree*>& list, vector<int>& coeffs, XCondition& cond) override;
+        void buildConstraintChannel(const std::string& id, std::vector<XVariable*>& list, int startIndex) override;
+        void buildConstraintChannel(const std::string& id, std::vector<XVariable*>& list1, int startIndex1, std::vector<XVariable*>& list2, int startIndex2) override;
+        void buildConstraintChannel(const std::string& id, std::vector<XVariable*>& list, int startIndex, XVariable* value) override;
 
-        virtual void buildConstraintSum(string id, vector<Tree*>& list, XCondition& cond) override;
+        void buildConstraintStretch(const std::string& id, std::vector<XVariable*>& list, std::vector<int>& values, std::vector<XInterval>& widths) override;
+        void buildConstraintStretch(const std::string& id, std::vector<XVariable*>& list, std::vector<int>& values, std::vector<XInterval>& widths, std::vector<std::vector<int>>& patterns) override;
 
-        virtual void buildConstraintAtMost(string id, vector<XVariable*>& list, int value, int k) override;
+        void buildConstraintNoOverlap(const std::string& id, std::vector<XVariable*>& origins, std::vector<int>& lengths, bool zeroIgnored) override;
+        void buildConstraintNoOverlap(const std::string& id, std::vector<XVariable*>& origins, std::vector<XVariable*>& lengths, bool zeroIgnored) override;
+        void buildConstraintNoOverlap(const std::string& id, std::vector<std::vector<XVariable*>>& origins, std::vector<std::vector<int>>& lengths, bool zeroIgnored) override;
+        void buildConstraintNoOverlap(const std::string& id, std::vector<std::vector<XVariable*>>& origins, std::vector<std::vector<XVariable*>>& lengths, bool zeroIgnored) override;
 
-        virtual void buildConstraintAtLeast(string id, vector<XVariable*>& list, int value, int k) override;
+        void buildConstraintInstantiation(const std::string& id, std::vector<XVariable*>& list, std::vector<int>& values) override;
 
-        virtual void buildConstraintExactlyK(string id, vector<XVariable*>& list, int value, int k) override;
+        void buildConstraintClause(const std::string& id, std::vector<XVariable*>& positive, std::vector<XVariable*>& negative) override;
 
-        virtual void buildConstraintAmong(string id, vector<XVariable*>& list, vector<int>& values, int k) override;
+        void buildConstraintCircuit(const std::string& id, std::vector<XVariable*>& list, int startIndex) override;
+        void buildConstraintCircuit(const std::string& id, std::vector<XVariable*>& list, int startIndex, int size) override;
+        void buildConstraintCircuit(const std::string& id, std::vector<XVariable*>& list, int startIndex, XVariable* size) override;
 
-        virtual void buildConstraintExactlyVariable(string id, vector<XVariable*>& list, int value, XVariable* x) override;
+        void buildConstraintCumulative(const std::string& id, std::vector<XVariable*>& origins, std::vector<int>& lengths, std::vector<int>& heights, XCondition& xc) override;
+        void buildConstraintCumulative(const std::string& id, std::vector<XVariable*>& origins, std::vector<XVariable*>& lengths, std::vector<int>& heights, XCondition& xc) override;
+        void buildConstraintCumulative(const std::string& id, std::vector<XVariable*>& origins, std::vector<int>& lengths, std::vector<XVariable*>& varHeights, XCondition& xc) override;
+        void buildConstraintCumulative(const std::string& id, std::vector<XVariable*>& origins, std::vector<XVariable*>& lengths, std::vector<XVariable*>& heights, XCondition& xc) override;
+        void buildConstraintCumulative(const std::string& id, std::vector<XVariable*>& origins, std::vector<int>& lengths, std::vector<int>& heights, std::vector<XVariable*>& ends, XCondition& xc) override;
+        void buildConstraintCumulative(const std::string& id, std::vector<XVariable*>& origins, std::vector<int>& lengths, std::vector<XVariable*>& varHeights, std::vector<XVariable*>& ends, XCondition& xc) override;
+        void buildConstraintCumulative(const std::string& id, std::vector<XVariable*>& origins, std::vector<XVariable*>& lengths, std::vector<int>& heights, std::vector<XVariable*>& ends, XCondition& xc) override;
+        void buildConstraintCumulative(const std::string& id, std::vector<XVariable*>& origins, std::vector<XVariable*>& lengths, std::vector<XVariable*>& heights, std::vector<XVariable*>& ends, XCondition& xc) override;
 
-        virtual void buildConstraintCount(string id, vector<XVariable*>& list, vector<int>& values, XCondition& xc) override;
+        void buildObjectiveMinimizeExpression(std::string expr) override;
+        void buildObjectiveMaximizeExpression(std::string expr) override;
 
-        virtual void buildConstraintCount(string id, vector<XVariable*>& list, vector<XVariable*>& values, XCondition& xc) override;
+        void buildObjectiveMinimizeVariable(XVariable* x) override;
+        void buildObjectiveMaximizeVariable(XVariable* x) override;
 
-        virtual void buildConstraintNValues(string id, vector<XVariable*>& list, vector<int>& except, XCondition& xc) override;
+        void buildObjectiveMinimize(ExpressionObjective type, std::vector<XVariable*>& list, std::vector<int>& coefs) override;
+        void buildObjectiveMaximize(ExpressionObjective type, std::vector<XVariable*>& list, std::vector<int>& coefs) override;
 
-        virtual void buildConstraintNValues(string id, vector<XVariable*>& list, XCondition& xc) override;
+        void buildObjectiveMinimize(ExpressionObjective type, std::vector<XVariable*>& list) override;
+        void buildObjectiveMaximize(ExpressionObjective type, std::vector<XVariable*>& list) override;
+
+        void buildObjectiveMinimize(ExpressionObjective type, std::vector<Tree*>& trees) override;
+        void buildObjectiveMaximize(ExpressionObjective type, std::vector<Tree*>& trees) override;
 
-        virtual void buildConstraintCardinality(string id, vector<XVariable*>& list, vector<int> values, vector<int>& occurs, bool closed) override;
+        void buildObjectiveMinimize(ExpressionObjective type, std::vector<Tree*>& trees, std::vector<int>& coefs) override;
+        void buildObjectiveMaximize(ExpressionObjective type, std::vector<Tree*>& trees, std::vector<int>& coefs) override;
 
-        virtual void buildConstraintCardinality(string id, vector<XVariable*>& list, vector<int> values, vector<XVariable*>& occurs,
-                                                bool closed) override;
-
-        virtual void buildConstraintCardinality(string id, vector<XVariable*>& list, vector<int> values, vector<XInterval>& occurs,
-                                                bool closed) override;
-
-        virtual void buildConstraintCardinality(string id, vector<XVariable*>& list, vector<XVariable*> values, vector<int>& occurs,
-                                                bool closed) override;
-
-        virtual void buildConstraintCardinality(string id, vector<XVariable*>& list, vector<XVariable*> values, vector<XVariable*>& occurs,
-                                                bool closed) override;
-
-        virtual void buildConstraintCardinality(string id, vector<XVariable*>& list, vector<XVariable*> values, vector<XInterval>& occurs,
-                                                bool closed) override;
-
-        virtual void buildConstraintCumulative(string id, vector<XVariable*>& origins, vector<int>& lengths, vector<int>& heights, vector<XVariable*>& ends,
-                                               XCondition& xc) override;
-
-        virtual void buildConstraintMinimum(string id, vector<XVariable*>& list, XCondition& xc) override;
-
-        virtual void buildConstraintMinimum(string id, vector<XVariable*>& list, XVariable* index, int startIndex, RankType rank,
-                                            XCondition& xc) override;
-
-        virtual void buildConstraintMaximum(string id, vector<XVariable*>& list, XCondition& xc) override;
-
-        virtual void buildConstraintMaximum(string id, vector<XVariable*>& list, XVariable* index, int startIndex, RankType rank,
-                                            XCondition& xc) override;
+    private:
+        unsigned long lastTuples; // the tuples of the last extensional constraint, shared by the next one with the "as" form
+
+        void constraint(const char* name) {
+            nbConstraints++;
+            constraintsByType[name]++;
+        }
+
+        static unsigned long countNodes(Node* node) {
+            unsigned long nb = 1;
+            for (Node* n : node->parameters)
+                nb += countNodes(n);
+            return nb;
+        }
+    };
 
-        virtual void buildConstraintElement(string id, vector<XVariable*>& list, int value) override;
+} // namespace XCSP3Core
 
-        virtual void buildConstraintElement(string id, vector<XVariable*>& list, XVariable* value) override;
+using namespace XCSP3Core;
 
-        virtual void buildConstraintElement(string id, vector<XVariable*>& list, int startIndex, XVariable* index, RankType rank, int value) override;
+XCSP3SummaryCallbacks::XCSP3SummaryCallbacks()
+    : XCSP3CoreCallbacksBase(), nbVariables(0), nbConstraints(0), nbObjectives(0), nbTuples(0), nbNodes(0), lastTuples(0) {
+    intensionUsingString = false;
+}
 
-        virtual void buildConstraintElement(string id, vector<XVariable*>& list, int startIndex, XVariable* index, RankType rank, XVariable* value) override;
+void XCSP3SummaryCallbacks::beginInstance(InstanceType t) {
+    type = t == InstanceType::COP ? "COP" : "CSP";
+    nbVariables = nbConstraints = nbObjectives = nbTuples = nbNodes = 0;
+    lastTuples = 0;
+    constraintsByType.clear();
+}
 
-        virtual void buildConstraintElement(string id, vector<int>& list, int startIndex, XVariable* index, RankType rank, XVariable* value) override;
+void XCSP3SummaryCallbacks::endInstance() {
+}
 
-        virtual void buildConstraintElement(string id, vector<vector<int>>& matrix, int startRowIndex, XVariable* rowIndex, int startColIndex, XVariable* colIndex, XVariable* value) override;
+void XCSP3SummaryCallbacks::beginVariables() {
+}
 
-        virtual void buildConstraintChannel(string id, vector<XVariable*>& list, int startIndex) override;
+void XCSP3SummaryCallbacks::endVariables() {
+}
 
-        virtual void buildConstraintChannel(string id, vector<XVariable*>& list1, int startIndex1, vector<XVariable*>& list2, int startIndex2) override;
+void XCSP3SummaryCallbacks::beginVariableArray(const std::string&) {
+}
 
-        virtual void buildConstraintChannel(string id, vector<XVariable*>& list, int startIndex, XVariable* value) override;
+void XCSP3SummaryCallbacks::endVariableArray() {
+}
 
-        virtual void buildConstraintStretch(string id, vector<XVariable*>& list, vector<int>& values, vector<XInterval>& widths) override;
+void XCSP3SummaryCallbacks::beginConstraints() {
+}
 
-        virtual void
-        buildConstraintStretch(string id, vector<XVariable*>& list, vector<int>& values, vector<XInterval>& widths, vector<vector<int>>& patterns) override;
+void XCSP3SummaryCallbacks::endConstraints() {
+}
 
-        virtual void buildConstraintNoOverlap(string id, vector<XVariable*>& origins, vector<int>& lengths, bool zeroIgnored) override;
+void XCSP3SummaryCallbacks::beginGroup(const std::string&) {
+}
 
-        virtual void buildConstraintNoOverlap(string id, vector<XVariable*>& origins, vector<XVariable*>& lengths, bool zeroIgnored) override;
+void XCSP3SummaryCallbacks::endGroup() {
+}
 
-        virtual void buildConstraintNoOverlap(string id, vector<vector<XVariable*>>& origins, vector<vector<int>>& lengths, bool zeroIgnored) override;
+bool XCSP3SummaryCallbacks::buildConstraintGroup(const std::string&, ConstraintType, XConstraint*, std::vector<XVariable*>&, int) {
+    return false;
+}
 
-        virtual void buildConstraintNoOverlap(string id, vector<vector<XVariable*>>& origins, vector<vector<XVariable*>>& lengths, bool zeroIgnored) override;
+bool XCSP3SummaryCallbacks::buildConstraintGroup(const std::string&, Tree*, std::vector<XVariable*>&, int) {
+    return false;
+}
 
-        virtual void buildConstraintInstantiation(string id, vector<XVariable*>& list, vector<int>& values) override;
+bool XCSP3SummaryCallbacks::buildConstraintSlice(const std::string&, ConstraintType, XConstraint*, XArraySlice&) {
+    return false;
+}
 
-        virtual void buildConstraintClause(string id, vector<XVariable*>& positive, vector<XVariable*>& negative) override;
+void XCSP3SummaryCallbacks::beginBlock(const std::string&) {
+}
 
-        virtual void buildConstraintCircuit(string id, vector<XVariable*>& list, int startIndex) override;
+void XCSP3SummaryCallbacks::endBlock() {
+}
 
-        virtual void buildConstraintCircuit(string id, vector<XVariable*>& list, int startIndex, int size) override;
+void XCSP3SummaryCallbacks::beginSlide(const std::string&, bool) {
+}
 
-        virtual void buildConstraintCircuit(string id, vector<XVariable*>& list, int startIndex, XVariable* size) override;
+void XCSP3SummaryCallbacks::endSlide() {
+}
 
-        virtual void buildObjectiveMinimizeExpression(string expr) override;
+void XCSP3SummaryCallbacks::beginObjectives() {
+}
 
-        virtual void buildObjectiveMaximizeExpression(string expr) override;
+void XCSP3SummaryCallbacks::endObjectives() {
+}
 
-        virtual void buildObjectiveMinimizeVariable(XVariable* x) override;
+void XCSP3SummaryCallbacks::beginAnnotations() {
+}
 
-        virtual void buildObjectiveMaximizeVariable(XVariable* x) override;
+void XCSP3SummaryCallbacks::endAnnotations() {
+}
 
-        virtual void buildObjectiveMinimize(ExpressionObjective type, vector<XVariable*>& list, vector<int>& coefs) override;
+void XCSP3SummaryCallbacks::buildVariableInteger(const std::string&, int, int) {
+    nbVariables++;
+}
 
-        virtual void buildObjectiveMaximize(ExpressionObjective type, vector<XVariable*>& list, vector<int>& coefs) override;
+void XCSP3SummaryCallbacks::buildVariableInteger(const std::string&, std::vector<int>&) {
+    nbVariables++;
+}
 
-        virtual void buildObjectiveMinimize(ExpressionObjective type, vector<XVariable*>& list) override;
+void XCSP3SummaryCallbacks::buildAnnotationDecision(std::vector<XVariable*>&) {
+}
 
-        virtual void buildObjectiveMaximize(ExpressionObjective type, vector<XVariable*>& list) override;
+void XCSP3SummaryCallbacks::buildConstraintTrue(const std::string&) {
+    constraint("true");
+}
 
-        virtual void buildAnnotationDecision(vector<XVariable*>& list) override;
-        bool canonize;
-    };
+void XCSP3SummaryCallbacks::buildConstraintFalse(const std::string&) {
+    constraint("false");
+}
 
-} // namespace XCSP3Core
+void XCSP3SummaryCallbacks::buildConstraintExtension(const std::string& id, std::vector<XVariable*> list, std::vector<std::vector<int>>& tuples, bool support, bool hasStar) {
+    buildConstraintExtensionSpan(id, list, tuples, support, hasStar);
+}
 
-using namespace XCSP3Core;
+void XCSP3SummaryCallbacks::buildConstraintExtension(const std::string&, XVariable*, std::vector<int>& tuples, bool, bool) {
+    constraint("extension");
+    nbTuples += tuples.size();
+    lastTuples = tuples.size();
+}
 
-XCSP3SummaryCallbacks::XCSP3SummaryCallbacks() : XCSP3CoreCallbacks(), canonize(true) {
-    nbv = 0;
-    nbc = 0;
+void XCSP3SummaryCallbacks::buildConstraintExtensionAs(const std::string& id, std::vector<XVariable*> list, bool support, bool hasStar) {
+    buildConstraintExtensionAsSpan(id, list, support, hasStar);
 }
 
-void XCSP3SummaryCallbacks::beginInstance(InstanceType _type) {
-    if (_type == InstanceType::CSP) {
-        minmax = "";
-        type = "";
-    }
+void XCSP3SummaryCallbacks::buildConstraintExtensionSpan(const std::string&, XSpan<XVariable*>, std::vector<std::vector<int>>& tuples, bool, bool) {
+    constraint("extension");
+    nbTuples += tuples.size();
+    lastTuples = tuples.size();
 }
 
-void XCSP3SummaryCallbacks::endInstance() {
-    std::cout << nbv << " " << nbc << " " << minmax << " " << type << std::endl;
+void XCSP3SummaryCallbacks::buildConstraintExtensionAsSpan(const std::string&, XSpan<XVariable*>, bool, bool) {
+    constraint("extension");
+    nbTuples += lastTuples;
 }
 
-void XCSP3SummaryCallbacks::beginVariables() {
+void XCSP3SummaryCallbacks::buildConstraintIntension(const std::string&, std::string) {
+    constraint("intension");
 }
 
-void XCSP3SummaryCallbacks::endVariables() {
+void XCSP3SummaryCallbacks::buildConstraintIntension(const std::string&, Tree* tree) {
+    constraint("intension");
+    nbNodes += countNodes(tree->root);
 }
 
-void XCSP3SummaryCallbacks::beginVariableArray(string id) {
+void XCSP3SummaryCallbacks::buildConstraintPrimitive(const std::string&, OrderType, XVariable*, int, XVariable*) {
+    constraint("primitive");
 }
 
-void XCSP3SummaryCallbacks::endVariableArray() {
+void XCSP3SummaryCallbacks::buildConstraintPrimitive(const std::string&, OrderType, XVariable*, int) {
+    constraint("primitive");
 }
 
-void XCSP3SummaryCallbacks::beginConstraints() {
+void XCSP3SummaryCallbacks::buildConstraintPrimitive(const std::string&, XVariable*, bool, int, int) {
+    constraint("primitive");
 }
 
-void XCSP3SummaryCallbacks::endConstraints() {
+void XCSP3SummaryCallbacks::buildConstraintRegular(const std::string&, std::vector<XVariable*>&, std::string, std::vector<std::string>&, std::vector<XTransition>&) {
+    constraint("regular");
 }
 
-void XCSP3SummaryCallbacks::beginGroup(string id) {
+void XCSP3SummaryCallbacks::buildConstraintMDD(const std::string&, std::vector<XVariable*>&, std::vector<XTransition>&) {
+    constraint("mdd");
 }
 
-void XCSP3SummaryCallbacks::endGroup() {
+void XCSP3SummaryCallbacks::buildConstraintAlldifferent(const std::string&, std::vector<XVariable*>&) {
+    constraint("allDifferent");
 }
 
-void XCSP3SummaryCallbacks::beginBlock(string classes) {
+void XCSP3SummaryCallbacks::buildConstraintAlldifferentExcept(const std::string&, std::vector<XVariable*>&, std::vector<int>&) {
+    constraint("allDifferent");
 }
 
-void XCSP3SummaryCallbacks::endBlock() {
+void XCSP3SummaryCallbacks::buildConstraintAlldifferent(const std::string&, std::vector<Tree*>& list) {
+    constraint("allDifferent");
+    for (Tree* tree : list)
+        nbNodes += countNodes(tree->root);
 }
 
-// string id, bool circular
-void XCSP3SummaryCallbacks::beginSlide(string id, bool) {
+void XCSP3SummaryCallbacks::buildConstraintAlldifferentList(const std::string&, std::vector<std::vector<XVariable*>>&) {
+    constraint("allDifferent");
 }
 
-void XCSP3SummaryCallbacks::endSlide() {
+void XCSP3SummaryCallbacks::buildConstraintAlldifferentMatrix(const std::string&, std::vector<std::vector<XVariable*>>&) {
+    constraint("allDifferent");
 }
 
-void XCSP3SummaryCallbacks::beginObjectives() {
+void XCSP3SummaryCallbacks::buildConstraintAllEqual(const std::string&, std::vector<XVariable*>&) {
+    constraint("allEqual");
 }
 
-void XCSP3SummaryCallbacks::endObjectives() {
+void XCSP3SummaryCallbacks::buildConstraintNotAllEqual(const std::string&, std::vector<XVariable*>&) {
+    constraint("notAllEqual");
 }
 
-void XCSP3SummaryCallbacks::beginAnnotations() {
+void XCSP3SummaryCallbacks::buildConstraintOrdered(const std::string&, std::vector<XVariable*>&, OrderType) {
+    constraint("ordered");
 }
 
-void XCSP3SummaryCallbacks::endAnnotations() {
+void XCSP3SummaryCallbacks::buildConstraintOrdered(const std::string&, std::vector<XVariable*>&, std::vector<int>&, OrderType) {
+    constraint("ordered");
 }
 
-void XCSP3SummaryCallbacks::buildVariableInteger(string id, int minValue, int maxValue) {
-    nbv++;
+void XCSP3SummaryCallbacks::buildConstraintLex(const std::string&, std::vector<std::vector<XVariable*>>&, OrderType) {
+    constraint("lex");
 }
 
-void XCSP3SummaryCallbacks::buildVariableInteger(string id, vector<int>& values) {
-    nbv++;
+void XCSP3SummaryCallbacks::buildConstraintLexMatrix(const std::string&, std::vector<std::vector<XVariable*>>&, OrderType) {
+    constraint("lex");
 }
 
-void XCSP3SummaryCallbacks::buildConstraintExtension(string id, vector<XVariable*> list, vector<vector<int>>& tuples, bool support, bool hasStar) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintSum(const std::string&, std::vector<XVariable*>&, std::vector<int>&, XCondition&) {
+    constraint("sum");
 }
 
-void XCSP3SummaryCallbacks::buildConstraintExtension(string id, XVariable* variable, vector<int>& tuples, bool support, bool hasStar) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintSum(const std::string&, std::vector<XVariable*>&, XCondition&) {
+    constraint("sum");
 }
 
-// string id, vector<XVariable *> list, bool support, bool hasStar
-void XCSP3SummaryCallbacks::buildConstraintExtensionAs(string id, vector<XVariable*>, bool, bool) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintSum(const std::string&, std::vector<XVariable*>&, std::vector<XVariable*>&, XCondition&) {
+    constraint("sum");
 }
 
-void XCSP3SummaryCallbacks::buildConstraintIntension(string id, string expr) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintSum(const std::string&, std::vector<Tree*>& list, std::vector<int>&, XCondition&) {
+    constraint("sum");
+    for (Tree* tree : list)
+        nbNodes += countNodes(tree->root);
 }
 
-void XCSP3SummaryCallbacks::buildConstraintIntension(string id, Tree* tree) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintSum(const std::string&, std::vector<Tree*>& list, XCondition&) {
+    constraint("sum");
+    for (Tree* tree : list)
+        nbNodes += countNodes(tree->root);
 }
 
-void XCSP3SummaryCallbacks::buildConstraintPrimitive(string id, OrderType, XVariable* x, int k, XVariable* y) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintMult(const std::string&, XVariable*, XVariable*, XVariable*) {
+    constraint("primitive");
 }
 
-void XCSP3SummaryCallbacks::buildConstraintPrimitive(string id, OrderType op, XVariable* x, int k) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintAtMost(const std::string&, std::vector<XVariable*>&, int, int) {
+    constraint("count");
 }
 
-void XCSP3SummaryCallbacks::buildConstraintPrimitive(string id, XVariable* x, bool in, int min, int max) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintAtLeast(const std::string&, std::vector<XVariable*>&, int, int) {
+    constraint("count");
 }
 
-// string id, vector<XVariable *> &list, string start, vector<string> &final, vector<XTransition> &transitions
-void XCSP3SummaryCallbacks::buildConstraintRegular(string, vector<XVariable*>& list, string start, vector<string>& final, vector<XTransition>& transitions) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintExactlyK(const std::string&, std::vector<XVariable*>&, int, int) {
+    constraint("count");
 }
 
-// string id, vector<XVariable *> &list, vector<XTransition> &transitions
-void XCSP3SummaryCallbacks::buildConstraintMDD(string, vector<XVariable*>& list, vector<XTransition>& transitions) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintAmong(const std::string&, std::vector<XVariable*>&, std::vector<int>&, int) {
+    constraint("count");
 }
 
-void XCSP3SummaryCallbacks::buildConstraintAlldifferent(string id, vector<XVariable*>& list) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintExactlyVariable(const std::string&, std::vector<XVariable*>&, int, XVariable*) {
+    constraint("count");
 }
 
-void XCSP3SummaryCallbacks::buildConstraintAlldifferentExcept(string id, vector<XVariable*>& list, vector<int>& except) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintCount(const std::string&, std::vector<XVariable*>&, std::vector<int>&, XCondition&) {
+    constraint("count");
 }
 
-void XCSP3SummaryCallbacks::buildConstraintAlldifferent(string id, vector<Tree*>& list) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintCount(const std::string&, std::vector<XVariable*>&, std::vector<XVariable*>&, XCondition&) {
+    constraint("count");
 }
 
-void XCSP3SummaryCallbacks::buildConstraintAlldifferentList(string id, vector<vector<XVariable*>>& lists) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintNValues(const std::string&, std::vector<XVariable*>&, std::vector<int>&, XCondition&) {
+    constraint("nValues");
 }
 
-void XCSP3SummaryCallbacks::buildConstraintAlldifferentMatrix(string id, vector<vector<XVariable*>>& matrix) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintNValues(const std::string&, std::vector<XVariable*>&, XCondition&) {
+    constraint("nValues");
 }
 
-void XCSP3SummaryCallbacks::buildConstraintAllEqual(string id, vector<XVariable*>& list) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintCardinality(const std::string&, std::vector<XVariable*>&, std::vector<int>, std::vector<int>&, bool) {
+    constraint("cardinality");
 }
 
-void XCSP3SummaryCallbacks::buildConstraintNotAllEqual(string id, vector<XVariable*>& list) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintCardinality(const std::string&, std::vector<XVariable*>&, std::vector<int>, std::vector<XVariable*>&, bool) {
+    constraint("cardinality");
 }
 
-// string id, vector<XVariable *> &list, OrderType order
-void XCSP3SummaryCallbacks::buildConstraintOrdered(string, vector<XVariable*>& list, OrderType order) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintCardinality(const std::string&, std::vector<XVariable*>&, std::vector<int>, std::vector<XInterval>&, bool) {
+    constraint("cardinality");
 }
 
-// string id, vector<XVariable *> &list, vector<int> &lengths, OrderType order
-void XCSP3SummaryCallbacks::buildConstraintOrdered(string, vector<XVariable*>& list, vector<int>& lengths, OrderType order) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintCardinality(const std::string&, std::vector<XVariable*>&, std::vector<XVariable*>, std::vector<int>&, bool) {
+    constraint("cardinality");
 }
 
-// string id, vector<vector<XVariable *>> &lists, OrderType order
-void XCSP3SummaryCallbacks::buildConstraintLex(string, vector<vector<XVariable*>>& lists, OrderType order) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintCardinality(const std::string&, std::vector<XVariable*>&, std::vector<XVariable*>, std::vector<XVariable*>&, bool) {
+    constraint("cardinality");
 }
 
-// string id, vector<vector<XVariable *>> &matrix, OrderType order
-void XCSP3SummaryCallbacks::buildConstraintLexMatrix(string, vector<vector<XVariable*>>& matrix, OrderType order) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintCardinality(const std::string&, std::vector<XVariable*>&, std::vector<XVariable*>, std::vector<XInterval>&, bool) {
+    constraint("cardinality");
 }
 
-// string id, vector<XVariable *> &list, vector<int> &coeffs, XCondition &cond
-void XCSP3SummaryCallbacks::buildConstraintSum(string, vector<XVariable*>& list, vector<int>& coeffs, XCondition& cond) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintMinimum(const std::string&, std::vector<XVariable*>&, XCondition&) {
+    constraint("minimum");
 }
 
-// string id, vector<XVariable *> &list, XCondition &cond
-void XCSP3SummaryCallbacks::buildConstraintSum(string, vector<XVariable*>& list, XCondition& cond) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintMinimum(const std::string&, std::vector<XVariable*>&, XVariable*, int, RankType, XCondition&) {
+    constraint("minimum");
 }
 
-// string id, vector<XVariable *> &list, vector<XVariable *> &coeffs, XCondition &cond
-void XCSP3SummaryCallbacks::buildConstraintSum(string, vector<XVariable*>& list, vector<XVariable*>& coeffs, XCondition& cond) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintMinimum(const std::string&, std::vector<Tree*>& list, XCondition&) {
+    constraint("minimum");
+    for (Tree* tree : list)
+        nbNodes += countNodes(tree->root);
 }
 
-void XCSP3SummaryCallbacks::buildConstraintSum(string id, vector<Tree*>& list, vector<int>& coeffs, XCondition& cond) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintMaximum(const std::string&, std::vector<XVariable*>&, XCondition&) {
+    constraint("maximum");
 }
 
-void XCSP3SummaryCallbacks::buildConstraintSum(string id, vector<Tree*>& list, XCondition& cond) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintMaximum(const std::string&, std::vector<XVariable*>&, XVariable*, int, RankType, XCondition&) {
+    constraint("maximum");
 }
 
-// string id, vector<XVariable *> &list, int value, int k
-void XCSP3SummaryCallbacks::buildConstraintAtMost(string, vector<XVariable*>& list, int value, int k) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintMaximum(const std::string&, std::vector<Tree*>& list, XCondition&) {
+    constraint("maximum");
+    for (Tree* tree : list)
+        nbNodes += countNodes(tree->root);
 }
 
-// string id, vector<XVariable *> &list, int value, int k
-void XCSP3SummaryCallbacks::buildConstraintAtLeast(string, vector<XVariable*>& list, int value, int k) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintElement(const std::string&, std::vector<XVariable*>&, int) {
+    constraint("element");
 }
 
-// string id, vector<XVariable *> &list, int value, int k
-void XCSP3SummaryCallbacks::buildConstraintExactlyK(string, vector<XVariable*>& list, int value, int k) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintElement(const std::string&, std::vector<XVariable*>&, XVariable*) {
+    constraint("element");
 }
 
-// string id, vector<XVariable *> &list, vector<int> &values, int k
-void XCSP3SummaryCallbacks::buildConstraintAmong(string, vector<XVariable*>& list, vector<int>& values, int k) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintElement(const std::string&, std::vector<XVariable*>&, int, XVariable*, RankType, int) {
+    constraint("element");
 }
 
-// string id, vector<XVariable *> &list, int value, XVariable *x
-void XCSP3SummaryCallbacks::buildConstraintExactlyVariable(string, vector<XVariable*>& list, int value, XVariable* x) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintElement(const std::string&, std::vector<XVariable*>&, int, XVariable*, RankType, XVariable*) {
+    constraint("element");
 }
 
-// string id, vector<XVariable *> &list, vector<int> &values, XCondition &xc
-void XCSP3SummaryCallbacks::buildConstraintCount(string, vector<XVariable*>& list, vector<int>& values, XCondition& xc) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintElement(const std::string&, std::vector<int>&, int, XVariable*, RankType, XVariable*) {
+    constraint("element");
 }
 
-// string id, vector<XVariable *> &list, vector<XVariable *> &values, XCondition &xc
-void XCSP3SummaryCallbacks::buildConstraintCount(string, vector<XVariable*>& list, vector<XVariable*>& values, XCondition& xc) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintElement(const std::string&, std::vector<std::vector<int>>&, int, XVariable*, int, XVariable*, XVariable*) {
+    constraint("element");
 }
 
-// string id, vector<XVariable *> &list, vector<int> &except, XCondition &xc
-void XCSP3SummaryCallbacks::buildConstraintNValues(string, vector<XVariable*>& list, vector<int>& except, XCondition& xc) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintElement(const std::string&, std::vector<std::vector<XVariable*>>&, int, XVariable*, int, XVariable*, XVariable*) {
+    constraint("element");
 }
 
-// string id, vector<XVariable *> &list, XCondition &xc
-void XCSP3SummaryCallbacks::buildConstraintNValues(string, vector<XVariable*>& list, XCondition& xc) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintElement(const std::string&, std::vector<std::vector<XVariable*>>&, int, XVariable*, int, XVariable*, int) {
+    constraint("element");
 }
 
-// string id, vector<XVariable *> &list, vector<int> values, vector<int> &occurs, bool closed
-void XCSP3SummaryCallbacks::buildConstraintCardinality(string, vector<XVariable*>& list, vector<int> values, vector<int>& occurs, bool closed) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintChannel(const std::string&, std::vector<XVariable*>&, int) {
+    constraint("channel");
 }
 
-// string id, vector<XVariable *> &list, vector<int> values, vector<XVariable *> &occurs, bool closed
-void XCSP3SummaryCallbacks::buildConstraintCardinality(string, vector<XVariable*>& list, vector<int> values, vector<XVariable*>& occurs, bool closed) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintChannel(const std::string&, std::vector<XVariable*>&, int, std::vector<XVariable*>&, int) {
+    constraint("channel");
 }
 
-// string id, vector<XVariable *> &list, vector<int> values, vector<XInterval> &occurs, bool closed
-void XCSP3SummaryCallbacks::buildConstraintCardinality(string, vector<XVariable*>& list, vector<int> values, vector<XInterval>& occurs, bool closed) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintChannel(const std::string&, std::vector<XVariable*>&, int, XVariable*) {
+    constraint("channel");
 }
 
-// string id, vector<XVariable *> &list, vector<XVariable *> values, vector<int> &occurs, bool closed
-void XCSP3SummaryCallbacks::buildConstraintCardinality(string, vector<XVariable*>& list, vector<XVariable*> values, vector<int>& occurs, bool closed) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintStretch(const std::string&, std::vector<XVariable*>&, std::vector<int>&, std::vector<XInterval>&) {
+    constraint("stretch");
 }
 
-// string id, vector<XVariable *> &list, vector<XVariable *> values, vector<XVariable *> &occurs, bool closed
-void XCSP3SummaryCallbacks::buildConstraintCardinality(string, vector<XVariable*>& list, vector<XVariable*> values, vector<XVariable*>& occurs, bool closed) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintStretch(const std::string&, std::vector<XVariable*>&, std::vector<int>&, std::vector<XInterval>&, std::vector<std::vector<int>>&) {
+    constraint("stretch");
 }
 
-// string id, vector<XVariable *> &list, vector<XVariable *> values, vector<XInterval> &occurs, bool closed
-void XCSP3SummaryCallbacks::buildConstraintCardinality(string, vector<XVariable*>& list, vector<XVariable*> values, vector<XInterval>& occurs, bool closed) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintNoOverlap(const std::string&, std::vector<XVariable*>&, std::vector<int>&, bool) {
+    constraint("noOverlap");
 }
 
-// string id, vector<XVariable *> &list, XCondition &xc
-void XCSP3SummaryCallbacks::buildConstraintMinimum(string, vector<XVariable*>& list, XCondition& xc) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintNoOverlap(const std::string&, std::vector<XVariable*>&, std::vector<XVariable*>&, bool) {
+    constraint("noOverlap");
 }
 
-// string id, vector<XVariable *> &list, XVariable *index, int startIndex, RankType rank, XCondition &xc
-void XCSP3SummaryCallbacks::buildConstraintMinimum(string, vector<XVariable*>& list, XVariable* index, int startIndex, RankType, XCondition& xc) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintNoOverlap(const std::string&, std::vector<std::vector<XVariable*>>&, std::vector<std::vector<int>>&, bool) {
+    constraint("noOverlap");
 }
 
-// string id, vector<XVariable *> &list, XCondition &xc
-void XCSP3SummaryCallbacks::buildConstraintMaximum(string, vector<XVariable*>& list, XCondition& xc) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintNoOverlap(const std::string&, std::vector<std::vector<XVariable*>>&, std::vector<std::vector<XVariable*>>&, bool) {
+    constraint("noOverlap");
 }
 
-// string id, vector<XVariable *> &list, XVariable *index, int startIndex, RankType rank, XCondition &xc
-void XCSP3SummaryCallbacks::buildConstraintMaximum(string, vector<XVariable*>& list, XVariable* index, int startIndex, RankType, XCondition& xc) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintInstantiation(const std::string&, std::vector<XVariable*>&, std::vector<int>&) {
+    constraint("instantiation");
 }
 
-// string id, vector<XVariable *> &list, int value
-void XCSP3SummaryCallbacks::buildConstraintElement(string, vector<XVariable*>& list, int value) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintClause(const std::string&, std::vector<XVariable*>&, std::vector<XVariable*>&) {
+    constraint("clause");
 }
 
-// string id, vector<XVariable *> &list, XVariable *value
-void XCSP3SummaryCallbacks::buildConstraintElement(string, vector<XVariable*>& list, XVariable* value) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintCircuit(const std::string&, std::vector<XVariable*>&, int) {
+    constraint("circuit");
 }
 
-// string id, vector<XVariable *> &list, int startIndex, XVariable *index, RankType rank, int value
-void XCSP3SummaryCallbacks::buildConstraintElement(string, vector<XVariable*>& list, int startIndex, XVariable* index, RankType, int value) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintCircuit(const std::string&, std::vector<XVariable*>&, int, int) {
+    constraint("circuit");
 }
 
-void XCSP3SummaryCallbacks::buildConstraintElement(string id, vector<vector<int>>& matrix, int startRowIndex, XVariable* rowIndex, int startColIndex, XVariable* colIndex, XVariable* value) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintCircuit(const std::string&, std::vector<XVariable*>&, int, XVariable*) {
+    constraint("circuit");
 }
 
-// string id, vector<XVariable *> &list, int startIndex, XVariable *index, RankType rank, XVariable *value
-void XCSP3SummaryCallbacks::buildConstraintElement(string, vector<XVariable*>& list, int startIndex, XVariable* index, RankType, XVariable* value) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintCumulative(const std::string&, std::vector<XVariable*>&, std::vector<int>&, std::vector<int>&, XCondition&) {
+    constraint("cumulative");
 }
 
-// string, vector<int> &list, int startIndex, XVariable *index, RankType rank, XVariable *value
-void XCSP3SummaryCallbacks::buildConstraintElement(string, vector<int>& list, int startIndex, XVariable* index, RankType, XVariable* value) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintCumulative(const std::string&, std::vector<XVariable*>&, std::vector<XVariable*>&, std::vector<int>&, XCondition&) {
+    constraint("cumulative");
 }
 
-// string id, vector<XVariable *> &list, int startIndex
-void XCSP3SummaryCallbacks::buildConstraintChannel(string, vector<XVariable*>& list, int startIndex) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintCumulative(const std::string&, std::vector<XVariable*>&, std::vector<int>&, std::vector<XVariable*>&, XCondition&) {
+    constraint("cumulative");
 }
 
-// string id, vector<XVariable *> &list1, int startIndex1, vector<XVariable *> &list2, int startIndex2
-void XCSP3SummaryCallbacks::buildConstraintChannel(string, vector<XVariable*>& list1, int, vector<XVariable*>& list2, int) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintCumulative(const std::string&, std::vector<XVariable*>&, std::vector<XVariable*>&, std::vector<XVariable*>&, XCondition&) {
+    constraint("cumulative");
 }
 
-// string id, vector<XVariable *> &list, int startIndex, XVariable *value
-void XCSP3SummaryCallbacks::buildConstraintChannel(string, vector<XVariable*>& list, int, XVariable* value) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintCumulative(const std::string&, std::vector<XVariable*>&, std::vector<int>&, std::vector<int>&, std::vector<XVariable*>&, XCondition&) {
+    constraint("cumulative");
 }
 
-// string id, vector<XVariable *> &list, vector<int> &values, vector<XInterval> &widths
-void XCSP3SummaryCallbacks::buildConstraintStretch(string, vector<XVariable*>& list, vector<int>& values, vector<XInterval>& widths) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintCumulative(const std::string&, std::vector<XVariable*>&, std::vector<int>&, std::vector<XVariable*>&, std::vector<XVariable*>&, XCondition&) {
+    constraint("cumulative");
 }
 
-// string id, vector<XVariable *> &list, vector<int> &values, vector<XInterval> &widths, vector<vector<int>> &patterns
-void XCSP3SummaryCallbacks::buildConstraintStretch(string, vector<XVariable*>& list, vector<int>& values, vector<XInterval>& widths, vector<vector<int>>& patterns) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintCumulative(const std::string&, std::vector<XVariable*>&, std::vector<XVariable*>&, std::vector<int>&, std::vector<XVariable*>&, XCondition&) {
+    constraint("cumulative");
 }
 
-// string id, vector<XVariable *> &origins, vector<int> &lengths, bool zeroIgnored
-void XCSP3SummaryCallbacks::buildConstraintNoOverlap(string, vector<XVariable*>& origins, vector<int>& lengths, bool) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildConstraintCumulative(const std::string&, std::vector<XVariable*>&, std::vector<XVariable*>&, std::vector<XVariable*>&, std::vector<XVariable*>&, XCondition&) {
+    constraint("cumulative");
 }
 
-// string id, vector<XVariable *> &origins, vector<XVariable *> &lengths, bool zeroIgnored
-void XCSP3SummaryCallbacks::buildConstraintNoOverlap(string, vector<XVariable*>& origins, vector<XVariable*>& lengths, bool) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildObjectiveMinimizeExpression(std::string) {
+    nbObjectives++;
 }
 
-// string id, vector<vector<XVariable *>> &origins, vector<vector<int>> &lengths, bool zeroIgnored
-void XCSP3SummaryCallbacks::buildConstraintNoOverlap(string, vector<vector<XVariable*>>& origins, vector<vector<int>>& lengths, bool) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildObjectiveMaximizeExpression(std::string) {
+    nbObjectives++;
 }
 
-// string id, vector<vector<XVariable *>> &origins, vector<vector<XVariable *>> &lengths, bool zeroIgnored
-void XCSP3SummaryCallbacks::buildConstraintNoOverlap(string, vector<vector<XVariable*>>& origins, vector<vector<XVariable*>>& lengths, bool) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildObjectiveMinimizeVariable(XVariable*) {
+    nbObjectives++;
 }
 
-// string id, vector<XVariable *> &list, vector<int> &values
-void XCSP3SummaryCallbacks::buildConstraintInstantiation(string, vector<XVariable*>& list, vector<int>& values) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildObjectiveMaximizeVariable(XVariable*) {
+    nbObjectives++;
 }
 
-// string id, vector<XVariable *> &list, vector<int> &values
-void XCSP3SummaryCallbacks::buildConstraintClause(string, vector<XVariable*>& positive, vector<XVariable*>& negative) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildObjectiveMinimize(ExpressionObjective, std::vector<XVariable*>&, std::vector<int>&) {
+    nbObjectives++;
 }
 
-// string id, vector<XVariable *> &list, int startIndex
-void XCSP3SummaryCallbacks::buildConstraintCircuit(string, vector<XVariable*>& list, int startIndex) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildObjectiveMaximize(ExpressionObjective, std::vector<XVariable*>&, std::vector<int>&) {
+    nbObjectives++;
 }
 
-// string id, vector<XVariable *> &list, int startIndex, int size
-void XCSP3SummaryCallbacks::buildConstraintCircuit(string, vector<XVariable*>& list, int startIndex, int size) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildObjectiveMinimize(ExpressionObjective, std::vector<XVariable*>&) {
+    nbObjectives++;
 }
 
-// string id, vector<XVariable *> &list, int startIndex, XVariable *size
-void XCSP3SummaryCallbacks::buildConstraintCircuit(string, vector<XVariable*>& list, int startIndex, XVariable* size) {
-    nbc++;
+void XCSP3SummaryCallbacks::buildObjectiveMaximize(ExpressionObjective, std::vector<XVariable*>&) {
+    nbObjectives++;
 }
 
-void XCSP3SummaryCallbacks::buildObjectiveMinimizeExpression(string expr) {
-    type = expr;
-    minmax = "Minimize";
+void XCSP3SummaryCallbacks::buildObjectiveMinimize(ExpressionObjective, std::vector<Tree*>& trees) {
+    nbObjectives++;
+    for (Tree* tree : trees)
+        nbNodes += countNodes(tree->root);
 }
 
-void XCSP3SummaryCallbacks::buildObjectiveMaximizeExpression(string expr) {
-    type = expr;
-    minmax = "Maximize";
+void XCSP3SummaryCallbacks::buildObjectiveMaximize(ExpressionObjective, std::vector<Tree*>& trees) {
+    nbObjectives++;
+    for (Tree* tree : trees)
+        nbNodes += countNodes(tree->root);
 }
 
-void XCSP3SummaryCallbacks::buildObjectiveMinimizeVariable(XVariable* x) {
-    type = "variable";
-    minmax = "Minimize";
+void XCSP3SummaryCallbacks::buildObjectiveMinimize(ExpressionObjective, std::vector<Tree*>& trees, std::vector<int>&) {
+    nbObjectives++;
+    for (Tree* tree : trees)
+        nbNodes += countNodes(tree->root);
 }
 
-void XCSP3SummaryCallbacks::buildObjectiveMaximizeVariable(XVariable* x) {
-    type = "variable";
-    minmax = "Maximize";
-}
-
-void XCSP3SummaryCallbacks::buildConstraintCumulative(string id, vector<XVariable*>& origins, vector<int>& lengths, vector<int>& heights, vector<XVariable*>& ends,
-                                                      XCondition& xc) { nbc++; }
+void XCSP3SummaryCallbacks::buildObjectiveMaximize(ExpressionObjective, std::vector<Tree*>& trees, std::vector<int>&) {
+    nbObjectives++;
+    for (Tree* tree : trees)
+        nbNodes += countNodes(tree->root);
+}
 
-void XCSP3SummaryCallbacks::buildObjectiveMinimize(ExpressionObjective _type, vector<XVariable*>& list, vector<int>& coefs) {
-    minmax = "Minimize";
-    switch (_type) {
-    case SUM_O:
-        type = "sum";
-        break;
-    case PRODUCT_O:
-        type = "product";
-        break;
-    case MINIMUM_O:
-        type = "minimum";
-        break;
-    case MAXIMUM_O:
-        type = "maximum";
-        break;
-    case NVALUES_O:
-        type = "nvalues";
-        break;
-    case LEX_O:
-        type = "lex";
-        break;
-    }
-}
-
-void XCSP3SummaryCallbacks::buildObjectiveMaximize(ExpressionObjective _type, vector<XVariable*>& list, vector<int>& coefs) {
-    minmax = "Maximize";
-    switch (_type) {
-    case SUM_O:
-        type = "sum";
-        break;
-    case PRODUCT_O:
-        type = "product";
-        break;
-    case MINIMUM_O:
-        type = "minimum";
-        break;
-    case MAXIMUM_O:
-        type = "maximum";
-        break;
-    case NVALUES_O:
-        type = "nvalues";
-        break;
-    case LEX_O:
-        type = "lex";
-        break;
-    }
-}
-
-void XCSP3SummaryCallbacks::buildObjectiveMinimize(ExpressionObjective _type, vector<XVariable*>& list) {
-    minmax = "Minimize";
-    switch (_type) {
-    case SUM_O:
-        type = "sum";
-        break;
-    case PRODUCT_O:
-        type = "product";
-        break;
-    case MINIMUM_O:
-        type = "minimum";
-        break;
-    case MAXIMUM_O:
-        type = "maximum";
-        break;
-    case NVALUES_O:
-        type = "nvalues";
-        break;
-    case LEX_O:
-        type = "lex";
-        break;
-    }
-}
-
-void XCSP3SummaryCallbacks::buildObjectiveMaximize(ExpressionObjective _type, vector<XVariable*>& list) {
-    minmax = "Maximize";
-    switch (_type) {
-    case SUM_O:
-        type = "sum";
-        break;
-    case PRODUCT_O:
-        type = "product";
-        break;
-    case MINIMUM_O:
-        type = "minimum";
-        break;
-    case MAXIMUM_O:
-        type = "maximum";
-        break;
-    case NVALUES_O:
-        type = "nvalues";
-        break;
-    case LEX_O:
-        type = "lex";
-        break;
-    default:
-        break;
-    }
-}
-
-void XCSP3SummaryCallbacks::buildAnnotationDecision(vector<XVariable*>& list) {
-}
-
-#endif //COSOCO_XCSP3SummaryCallbacks_H
+#endif // COSOCO_XCSP3SummaryCallbacks_H
@@ -0,0 +1,232 @@
+#include "XCSP3CoreParser.h"
+#include "XCSP3SummaryCallbacks.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <mutex>
+#include <sstream>
+#include <sys/stat.h>
+#include <thread>
+
+using namespace XCSP3Core;
+
+/**
+ * Parse many instances with one process: ./batchXcsp3 [-j threads] file-or-directory...
+ * Directories are explored recursively for .xml files. Each instance is parsed by new callbacks and a new parser in a worker thread:
+ * a reused parser keeps a block of each pool and the libxml2 context, so the peak memory of a file would depend on the instances
+ * parsed before it by the same thread.
+ * One JSON line of statistics is printed by instance, in the order of the files. The exit code is 1 if an instance fails.
+ * The memory is counted by thread: memory allocated by another thread is not seen (unfoldingThreads is left to 1).
+ */
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+static size_t sizeOf(void* p) {
+    return malloc_usable_size(p);
+}
+#else
+static size_t sizeOf(void*) {
+    return 0; // peak memory is not measured
+}
+#endif
+
+// Heap used by the current thread (operator new, libxml2 and the pools of the parser), to give the peak memory of a parse.
+// Memory freed by another thread than the one that allocated it is not accounted right: the parse of an instance stays in one thread.
+static thread_local long long allocated = 0;
+static thread_local long long peak = 0;
+
+static void allocate(void* p) {
+    allocated += sizeOf(p);
+    if (allocated > peak)
+        peak = allocated;
+}
+
+static void release(void* p) {
+    allocated -= sizeOf(p);
+}
+
+void* operator new(size_t size) {
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr)
+        throw std::bad_alloc();
+    allocate(p);
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    if (p == nullptr)
+        return;
+    release(p);
+    std::free(p);
+}
+
+static void* countingMalloc(size_t size) {
+    void* p = std::malloc(size);
+    if (p != nullptr)
+        allocate(p);
+    return p;
+}
+
+static void* countingRealloc(void* p, size_t size) {
+    if (p != nullptr)
+        release(p);
+    void* q = std::realloc(p, size);
+    if (q != nullptr)
+        allocate(q);
+    else if (p != nullptr)
+        allocate(p);
+    return q;
+}
+
+static void countingFree(void* p) {
+    if (p == nullptr)
+        return;
+    release(p);
+    std::free(p);
+}
+
+static char* countingStrdup(const char* s) {
+    char* p = static_cast<char*>(countingMalloc(std::strlen(s) + 1));
+    if (p != nullptr)
+        std::strcpy(p, s);
+    return p;
+}
+
+static void collect(const std::string& path, std::vector<std::string>& files) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0 || S_ISDIR(st.st_mode) == false) {
+        files.push_back(path); // a missing file is reported as a failed instance
+        return;
+    }
+    DIR* dir = opendir(path.c_str());
+    if (dir == nullptr)
+        return;
+    std::vector<std::string> entries;
+    while (struct dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name == "." || name == "..")
+            continue;
+        std::string child = path + "/" + name;
+        if (stat(child.c_str(), &st) != 0)
+            continue;
+        if (S_ISDIR(st.st_mode) || (name.size() > 4 && name.compare(name.size() - 4, 4, ".xml") == 0))
+            entries.push_back(child);
+    }
+    closedir(dir);
+    std::sort(entries.begin(), entries.end());
+    for (const std::string& entry : entries)
+        collect(entry, files);
+}
+
+static std::string quote(const std::string& s) {
+    std::string result = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            result += '\\';
+            result += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buffer[8];
+            snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned int>(c));
+            result += buffer;
+        } else
+            result += c;
+    }
+    return result + "\"";
+}
+
+// Return false if the instance can not be parsed
+static bool parseInstance(const std::string& file, std::string& result) {
+    std::ostringstream json;
+    std::string error;
+    long long start = allocated;
+    peak = allocated;
+    auto begin = std::chrono::steady_clock::now();
+    XCSP3SummaryCallbacks cb;
+    {
+        XCSP3CoreParser parser(&cb);
+        try {
+            parser.parse(file.c_str());
+        } catch (std::exception& e) {
+            error = e.what();
+            if (error.empty() == false && error.back() == '\n')
+                error.pop_back();
+        }
+    }
+    double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    long long used = peak - start;
+
+    json << "{\"instance\":" << quote(file);
+    if (error.empty()) {
+        json << ",\"status\":\"ok\",\"type\":" << quote(cb.type) << ",\"variables\":" << cb.nbVariables << ",\"constraints\":" << cb.nbConstraints
+             << ",\"constraintsByType\":{";
+        bool first = true;
+        for (auto& c : cb.constraintsByType) {
+            json << (first ? "" : ",") << quote(c.first) << ":" << c.second;
+            first = false;
+        }
+        json << "},\"objectives\":" << cb.nbObjectives << ",\"tuples\":" << cb.nbTuples << ",\"treeNodes\":" << cb.nbNodes;
+    } else
+        json << ",\"status\":\"error\",\"error\":" << quote(error);
+    json << ",\"parseTime\":" << time << ",\"peakMemory\":" << used << "}";
+    result = json.str();
+    return error.empty();
+}
+
+int main(int argc, char** argv) {
+    size_t nbThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+            nbThreads = std::max(1, std::atoi(argv[++i]));
+        else
+            collect(argv[i], files);
+    }
+    if (files.empty()) {
+        std::cerr << "usage: ./batchXcsp3 [-j threads] file-or-directory..." << std::endl;
+        return 2;
+    }
+    nbThreads = std::min(nbThreads, files.size());
+
+    // Must be done before any use of libxml2
+    xmlMemSetup(countingFree, countingMalloc, countingRealloc, countingStrdup);
+
+    // JSON lines go to the standard output, messages of the parser are sent to the error output
+    std::ostream out(std::cout.rdbuf());
+    std::cout.rdbuf(std::cerr.rdbuf());
+
+    std::vector<std::string> results(files.size());
+    std::vector<bool> done(files.size(), false);
+    size_t printed = 0;
+    std::mutex lock;
+    std::atomic<size_t> next(0);
+    std::atomic<bool> failed(false);
+
+    auto worker = [&]() {
+        for (size_t i = next++; i < files.size(); i = next++) {
+            std::string json;
+            if (parseInstance(files[i], json) == false)
+                failed = true;
+            std::lock_guard<std::mutex> guard(lock);
+            results[i] = json;
+            done[i] = true;
+            for (; printed < files.size() && done[printed]; printed++) {
+                out << results[printed] << std::endl;
+                results[printed].clear();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < nbThreads; t++)
+        threads.emplace_back(worker);
+    worker();
+    for (std::thread& t : threads)
+        t.join();
+
+    std::cout.rdbuf(out.rdbuf());
+    return failed ? 1 : 0;
+}
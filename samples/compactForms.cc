@@ -0,0 +1,49 @@
+#include "XCSP3Domain.h"
+#include "XCSP3Pool.h"
+#include "XCSP3Variable.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using namespace XCSP3Core;
+
+/**
+ * Microbenchmark of compact forms: ./compactFormsXcsp3 [scale]
+ * XVariableArray::getVarsFor is called on x[100][100] and z[10000] with forms such as x[3][], x[][2..7] and z[].
+ * For each form, the time by call and the number of objects it leaves in the pool are printed.
+ * The number of calls of each form is multiplied by scale (1 by default).
+ */
+
+int main(int argc, char** argv) {
+    int scale = argc > 1 ? std::max(1, std::atoi(argv[1])) : 1;
+    DataPool pool;
+    DataPool::Use use(pool);
+    XDomainInteger* domain = pool.DomainPool.make<XDomainInteger>();
+    domain->addValue(0);
+    XVariableArray* x = pool.EntityPool.make<XVariableArray>("x", std::vector<int>{100, 100});
+    x->buildVarsWith(domain);
+    XVariableArray* z = pool.EntityPool.make<XVariableArray>("z", std::vector<int>{10000});
+    z->buildVarsWith(domain);
+
+    struct {
+        XVariableArray* array;
+        const char* form;
+        int calls;
+    } cases[] = {{x, "[3][]", 200000}, {x, "[][2..7]", 100000}, {z, "[]", 2000}, {z, "[5]", 1000000}, {x, "[1..2][4..5]", 500000}};
+
+    std::vector<XVariable*> list;
+    for (auto& c : cases) {
+        int calls = c.calls * scale;
+        size_t before = pool.IntegerEntityPool.size();
+        auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < calls; i++) {
+            list.clear();
+            c.array->getVarsFor(list, c.form);
+        }
+        double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        std::cout << c.array->id << c.form << ": " << time * 1e9 / calls << " ns/call, " << list.size() << " variables, "
+                  << (pool.IntegerEntityPool.size() - before) / calls << " pool entries/call" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include "XCSP3CoreParser.h"
+#include "XCSP3SummaryCallbacks.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <sstream>
+
+using namespace XCSP3Core;
+
+/**
+ * Benchmark of the cache of intension constraints: ./intensionCacheXcsp3 [constraints]
+ * An instance is generated with intension constraints of 13 shapes over random variables and constants
+ * (100000 constraints by default). It is parsed with cacheIntensionTemplates off, then on:
+ * the parse time, the hits and misses of the cache and the number of tree nodes are printed.
+ */
+
+static const char* shapes[] = {"ne(%,add(%,#))", "eq(add(%,%),%)", "le(add(%,#),%)", "lt(%,%)", "ne(%,%)", "or(lt(add(%,#),%),lt(add(%,#),%))",
+                               "eq(%,#)", "eq(mul(%,%),%)", "in(%,set(1,3,#))", "ge(dist(%,%),#)", "and(le(%,#),le(#,%))", "ne(sub(%,%),#)",
+                               "lt(#,%)"};
+
+// % is replaced by a variable, # by a constant
+static std::string generate(int nbConstraints) {
+    const int nbVariables = 200;
+    unsigned int seed = 1;
+    auto random = [&seed](int n) {
+        seed = seed * 1103515245u + 12345u;
+        return static_cast<int>((seed >> 16) % static_cast<unsigned int>(n));
+    };
+    std::ostringstream instance;
+    instance << "<instance format=\"XCSP3\" type=\"CSP\">\n<variables>\n<array id=\"x\" size=\"[" << nbVariables
+             << "]\"> 0..50 </array>\n</variables>\n<constraints>\n";
+    for (int i = 0; i < nbConstraints; i++) {
+        instance << "<intension> ";
+        for (const char* c = shapes[random(sizeof(shapes) / sizeof(shapes[0]))]; *c; c++) {
+            if (*c == '%')
+                instance << "x[" << random(nbVariables) << "]";
+            else if (*c == '#')
+                instance << random(6);
+            else
+                instance << *c;
+        }
+        instance << " </intension>\n";
+    }
+    instance << "</constraints>\n</instance>\n";
+    return instance.str();
+}
+
+int main(int argc, char** argv) {
+    int nbConstraints = argc > 1 ? std::max(1, std::atoi(argv[1])) : 100000;
+    std::string instance = generate(nbConstraints);
+
+    // Messages of the pools are sent to the error output
+    std::streambuf* out = std::cout.rdbuf(std::cerr.rdbuf());
+    std::ostringstream results;
+    for (bool cache : {false, true}) {
+        XCSP3SummaryCallbacks cb;
+        cb.cacheIntensionTemplates = cache;
+        XCSP3CoreParser parser(&cb);
+        std::istringstream in(instance);
+        auto begin = std::chrono::steady_clock::now();
+        parser.parse(in);
+        double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        results << "cache " << (cache ? "on: " : "off:") << " " << time << " s, " << cb.nbConstraints << " constraints, "
+                << cb.statistics().intensionCacheHits << " hits, " << cb.statistics().intensionCacheMisses << " misses, " << cb.nbNodes
+                << " nodes" << std::endl;
+    }
+    std::cout.rdbuf(out);
+    std::cout << results.str();
+    return 0;
+}
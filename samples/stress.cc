@@ -0,0 +1,98 @@
+#include "XCSP3CoreParser.h"
+#include "XCSP3SummaryCallbacks.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace XCSP3Core;
+
+/**
+ * Stress test of concurrent parsing: ./stressXcsp3 [-j threads] [-r rounds] instance.xml...
+ * The instances are first parsed one after the other by a single parser. Then each one is parsed rounds times
+ * by threads parsers at the same time (one per thread, reused from one instance to the next), and each result
+ * must be equal to the sequential one. The exit code is 1 if a result differs.
+ */
+
+// Messages of the parser (pools, exceptions) are not printed
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override {
+        return c;
+    }
+};
+
+// Everything the callbacks have seen, or the error of the parse
+static std::string summarize(const char* file, XCSP3CoreParser& parser, XCSP3SummaryCallbacks& cb) {
+    std::ostringstream summary;
+    try {
+        parser.parse(file);
+    } catch (std::exception& e) {
+        return std::string("error ") + e.what();
+    }
+    summary << cb.type << " variables=" << cb.nbVariables << " constraints=" << cb.nbConstraints << " objectives=" << cb.nbObjectives
+            << " tuples=" << cb.nbTuples << " nodes=" << cb.nbNodes;
+    for (auto& c : cb.constraintsByType)
+        summary << " " << c.first << "=" << c.second;
+    return summary.str();
+}
+
+int main(int argc, char** argv) {
+    size_t nbThreads = 8, nbRounds = 4;
+    std::vector<const char*> files;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+            nbThreads = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+            nbRounds = std::max(1, std::atoi(argv[++i]));
+        else
+            files.push_back(argv[i]);
+    }
+    if (files.empty()) {
+        std::cerr << "usage: ./stressXcsp3 [-j threads] [-r rounds] instance.xml..." << std::endl;
+        return 2;
+    }
+
+    NullBuffer null;
+    std::streambuf* out = std::cout.rdbuf(&null);
+
+    std::vector<std::string> expected(files.size());
+    {
+        XCSP3SummaryCallbacks cb;
+        XCSP3CoreParser parser(&cb);
+        for (size_t i = 0; i < files.size(); i++)
+            expected[i] = summarize(files[i], parser, cb);
+    }
+
+    // Each thread takes the next parse: instances are mixed between threads and parsed concurrently
+    std::atomic<size_t> next(0);
+    std::atomic<size_t> nbDifferences(0);
+    std::mutex lock;
+    auto worker = [&]() {
+        XCSP3SummaryCallbacks cb;
+        XCSP3CoreParser parser(&cb);
+        for (size_t job = next++; job < files.size() * nbRounds; job = next++) {
+            size_t i = job % files.size();
+            std::string result = summarize(files[i], parser, cb);
+            if (result != expected[i]) {
+                nbDifferences++;
+                std::lock_guard<std::mutex> guard(lock);
+                std::cerr << files[i] << "\n  sequential: " << expected[i] << "\n  concurrent: " << result << std::endl;
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < nbThreads; t++)
+        threads.emplace_back(worker);
+    for (std::thread& t : threads)
+        t.join();
+
+    std::cout.rdbuf(out);
+    std::cout << files.size() << " instances parsed " << nbRounds << " times by " << nbThreads << " threads: " << nbDifferences
+              << " differences with the sequential parse" << std::endl;
+    return nbDifferences > 0 ? 1 : 0;
+}
@@ -0,0 +1,68 @@
+#include "XCSP3CoreParser.h"
+#include "XCSP3SummaryCallbacks.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <sstream>
+#include <thread>
+
+using namespace XCSP3Core;
+
+/**
+ * Benchmark of unfoldingThreads: ./unfoldingXcsp3 [rows] [max threads]
+ * An instance is generated with one intensional group of rows (1000000 by default) and one allDifferent group
+ * of rows / 10. It is parsed with 1, 2, 4... threads up to max threads (32 by default) and cacheIntensionTemplates
+ * false, so that the rows are unfolded in parallel. The parser never uses more threads than cores:
+ * larger counts are not measured.
+ */
+
+static std::string generate(int nbRows) {
+    const int nbVariables = 1000;
+    unsigned int seed = 1;
+    auto random = [&seed](int n) {
+        seed = seed * 1103515245u + 12345u;
+        return static_cast<int>((seed >> 16) % static_cast<unsigned int>(n));
+    };
+    std::ostringstream instance;
+    instance << "<instance format=\"XCSP3\" type=\"CSP\">\n<variables>\n<array id=\"x\" size=\"[" << nbVariables
+             << "]\"> 0..100 </array>\n</variables>\n<constraints>\n";
+    instance << "<group>\n<intension> or(le(add(%0,%1),%2),eq(dist(%0,%2),%1)) </intension>\n";
+    for (int i = 0; i < nbRows; i++)
+        instance << "<args> x[" << random(nbVariables) << "] x[" << random(nbVariables) << "] x[" << random(nbVariables) << "] </args>\n";
+    instance << "</group>\n<group>\n<allDifferent> %0 %1 %2 %3 </allDifferent>\n";
+    for (int i = 0; i < nbRows / 10; i++)
+        instance << "<args> x[" << random(nbVariables) << "] x[" << random(nbVariables) << "] x[" << random(nbVariables) << "] x["
+                 << random(nbVariables) << "] </args>\n";
+    instance << "</group>\n</constraints>\n</instance>\n";
+    return instance.str();
+}
+
+int main(int argc, char** argv) {
+    int nbRows = argc > 1 ? std::max(1, std::atoi(argv[1])) : 1000000;
+    int maxThreads = argc > 2 ? std::max(1, std::atoi(argv[2])) : 32;
+    int cores = std::max(1u, std::thread::hardware_concurrency());
+    std::string instance = generate(nbRows);
+
+    // Messages of the pools are sent to the error output
+    std::streambuf* out = std::cout.rdbuf(std::cerr.rdbuf());
+    std::ostringstream results;
+    results << nbRows << " rows, " << cores << " cores" << std::endl;
+    double reference = 0;
+    for (int nbThreads = 1; nbThreads <= std::min(maxThreads, cores); nbThreads *= 2) {
+        XCSP3SummaryCallbacks cb;
+        cb.cacheIntensionTemplates = false;
+        cb.unfoldingThreads = nbThreads;
+        XCSP3CoreParser parser(&cb);
+        std::istringstream in(instance);
+        auto begin = std::chrono::steady_clock::now();
+        parser.parse(in);
+        double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        if (nbThreads == 1)
+            reference = time;
+        results << nbThreads << " threads: " << time << " s, speedup " << reference / time << ", " << cb.nbConstraints << " constraints, "
+                << cb.nbNodes << " nodes" << std::endl;
+    }
+    std::cout.rdbuf(out);
+    std::cout << results.str();
+    return 0;
+}
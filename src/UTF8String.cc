@@ -25,6 +25,10 @@
  */
 
 #include "UTF8String.h"
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 using namespace XCSP3Core;
 
@@ -230,36 +234,61 @@ bool UTF8String::to(std::string& v) const {
 }
 
 bool UTF8String::to(int& v) const {
-    iterator it(_beg), end(_end);
-    bool neg = false;
+    const Byte *p = _beg, *e = end().getPointer();
 
-    while (it != end && it.isWhiteSpace())
-        ++it;
+    while (p != e && iterator(p).isWhiteSpace())
+        ++p;
 
-    if (it == end || it.firstByte() == 0) // end of string?
+    const Byte* digits = p;
+    p = parseInteger(p, e, v);
+    if (p == digits)
         return false;
 
-    if (*it == '+')
-        ++it;
-    else if (*it == '-') {
-        ++it;
-        neg = true;
-    }
-
-    v = 0;
-    while (it != end && *it >= '0' && *it <= '9') {
-        //??? #warning "must check for overflows"
-        v = v * 10 + (*it - '0');
-        ++it;
-    }
+    while (p != e && iterator(p).isWhiteSpace())
+        ++p;
 
-    if (neg)
-        v = -v;
+    return p == e || *p == 0;
+}
 
-    while (it != end && it.isWhiteSpace())
-        ++it;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+// Value of 8 digits read as a little endian word, or -1 if one of the bytes is not a digit
+static long long eightDigits(const Byte* p) {
+    unsigned long long word;
+    memcpy(&word, p, 8);
+    if (((word & 0xF0F0F0F0F0F0F0F0ULL) | ((word + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4) != 0x3333333333333333ULL)
+        return -1;
+    word -= 0x3030303030303030ULL;
+    word = (word * 10 + (word >> 8)) & 0x00FF00FF00FF00FFULL;
+    word = (word * 100 + (word >> 16)) & 0x0000FFFF0000FFFFULL;
+    word = (word * 10000 + (word >> 32)) & 0xFFFFFFFFULL;
+    return static_cast<long long>(word);
+}
+#endif
 
-    return it == end || it.firstByte() == 0;
+const Byte* UTF8String::parseInteger(const Byte* b, const Byte* e, int& v) {
+    const Byte* p = b;
+    bool neg = p != e && *p == '-';
+    if (p != e && (*p == '-' || *p == '+'))
+        ++p;
+    const Byte* digits = p;
+    const unsigned long long limit = neg ? 2147483648ULL : 2147483647ULL;
+    unsigned long long value = 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    // Runs of 8 digits at once (SWAR)
+    for (long long eight; e - p >= 8 && (eight = eightDigits(p)) >= 0 && value <= limit; p += 8)
+        value = value * 100000000ULL + static_cast<unsigned long long>(eight);
+#endif
+    for (; p != e && *p >= '0' && *p <= '9' && value <= limit; ++p)
+        value = value * 10 + (*p - '0');
+    if (p == digits)
+        return b;
+    if (value > limit || (p != e && *p >= '0' && *p <= '9')) {
+        while (p != e && *p >= '0' && *p <= '9')
+            ++p;
+        throw std::runtime_error("integer out of range: " + std::string(reinterpret_cast<const char*>(b), reinterpret_cast<const char*>(p)));
+    }
+    v = neg ? static_cast<int>(-static_cast<long long>(value)) : static_cast<int>(value);
+    return p;
 }
 
 void UTF8String::appendTo(std::string& v) const {
@@ -323,14 +352,15 @@ UTF8String::iterator::iterator(const Byte* s) {
 
 int UTF8String::iterator::operator*() {
     int ch = *p;
+    if (ch < 0x80) // ASCII
+        return ch;
 
+    const Byte* start = p; // addNextByte moves p, the iterator must stay on the character
     switch (codeLength(ch)) {
-    case 1:
-        return ch;
     case 2:
         ch &= 0x1F;
         addNextByte(ch);
-        return ch;
+        break;
     case 3:
         if ((ch == 0xE0 && p[1] < 0xA0) || (ch == 0xED && p[1] > 0x9F))
             throw std::runtime_error("invalid UTF8 character");
@@ -338,7 +368,7 @@ int UTF8String::iterator::operator*() {
         ch &= 0x0F;
         addNextByte(ch);
         addNextByte(ch);
-        return ch;
+        break;
     case 4:
         if ((ch == 0xF0 && p[1] < 0x90) || (ch == 0xF4 && p[1] > 0x8F))
             throw std::runtime_error("invalid UTF8 character");
@@ -347,10 +377,12 @@ int UTF8String::iterator::operator*() {
         addNextByte(ch);
         addNextByte(ch);
         addNextByte(ch);
-        return ch;
+        break;
     default:
         throw std::runtime_error("internal bug");
     }
+    p = start;
+    return ch;
 }
 
 UTF8String::iterator& UTF8String::iterator::operator++() // prefix
@@ -408,8 +440,34 @@ Byte UTF8String::iterator::firstByte() const {
     return *p;
 }
 
-//------------------------ ITERATOR INTERN CLASS ------------------------
-UTF8String::Tokenizer::Tokenizer(const UTF8String s) : it(s._beg), end(s._end) {
+bool UTF8String::isAscii(const Byte* b, const Byte* e) {
+#if defined(__SSE2__)
+    for (; e - b >= 16; b += 16)
+        if (_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b))) != 0)
+            return false;
+#endif
+    // 8 bytes at a time
+    for (; e - b >= 8; b += 8) {
+        unsigned long long word;
+        memcpy(&word, b, 8);
+        if (word & 0x8080808080808080ULL)
+            return false;
+    }
+    for (; b != e; ++b)
+        if (*b & 0x80)
+            return false;
+    return true;
+}
+
+//------------------------ TOKENIZER INTERN CLASS ------------------------
+UTF8String::Tokenizer::Tokenizer(const UTF8String s) : it(s._beg), end(s.end()) {
+    ascii = isAscii(it.getPointer(), end.getPointer());
+    memset(classes, TOKEN, sizeof(classes));
+    classes[0] = END;
+    for (int ch : {' ', '\n', '\r', '\t', '\v', '\f'})
+        classes[ch] = SPACE;
+    if (ascii == false) // stop on non ASCII bytes to decode them
+        memset(classes + 128, END, 128);
     skipWhiteSpace();
 }
 
@@ -417,28 +475,44 @@ UTF8String::Tokenizer::Tokenizer(const UTF8String s) : it(s._beg), end(s._end) {
  * Character ch will be returned as one token
  */
 void UTF8String::Tokenizer::addSeparator(int ch) {
-    separators.push_back(ch);
+    if (ch < 128)
+        classes[ch] |= SEPARATOR;
+    else
+        separators.push_back(ch);
 }
 
 bool UTF8String::Tokenizer::hasMoreTokens() {
-    return it != end && *it;
+    return it != end && it.firstByte();
 }
 
 UTF8String UTF8String::Tokenizer::nextToken() {
-    const Byte *b = it.getPointer(), *e;
+    const Byte *b = it.getPointer(), *p = b, *e = end.getPointer();
 
-    if (it == end || it.firstByte() == 0)
+    if (p == e || *p == 0)
         return UTF8String();
 
-    if (isSeparator(*it))
-        ++it;
-    else
-        while (it != end && *it && !it.isWhiteSpace() && !isSeparator(*it))
-            ++it;
-
-    e = it.getPointer();
+    if (classes[*p] & SEPARATOR)
+        ++p;
+    else if (ascii) {
+        while (p != e && classes[*p] == TOKEN)
+            ++p;
+    } else {
+        // Bytes are read until a non ASCII one, which is decoded
+        if (*p >= 128 && isSeparator(*it))
+            p = (++it).getPointer();
+        else
+            for (;;) {
+                while (p != e && classes[*p] == TOKEN)
+                    ++p;
+                if (p == e || *p < 128 || isSeparator(*iterator(p)))
+                    break;
+                iterator next(p);
+                p = (++next).getPointer();
+            }
+    }
 
+    it = iterator(p);
     skipWhiteSpace();
 
-    return UTF8String(b, e);
+    return UTF8String(b, p);
 }
@@ -35,16 +35,6 @@
 using namespace XCSP3Core;
 
 namespace XCSP3Core {
-    // Special global vars...
-    std::vector<XTransition> tr; // Not beautiful but remove code to fixed data in group constraint.
-    std::string st;
-    std::vector<std::string> fi;
-    std::vector<int> _except;
-    OrderType _op;
-    std::vector<int> _values;
-
-    int XParameterVariable::max;
-
     //------------------------------------------------------------------------------------------
     //  XCSP3Domain.h functions
     //------------------------------------------------------------------------------------------
@@ -64,16 +54,18 @@ namespace XCSP3Core {
 //  XCSP3Variable.h functions
 //------------------------------------------------------------------------------------------
 
-XEntity::XEntity() : id("") {}
+XEntity::XEntity() : id(""), kind(EntityKind::ENTITY) {}
 
 XEntity::~XEntity() {}
 
-XEntity::XEntity(std::string lid) { id = lid; }
+XEntity::XEntity(std::string lid) : kind(EntityKind::ENTITY) { id = lid; }
 
-XVariable::XVariable(std::string idd, XDomainInteger* dom) : XEntity(idd), domain(dom) {}
+XVariable::XVariable(std::string idd, XDomainInteger* dom) : XEntity(idd), domain(dom), index(-1) { kind = EntityKind::VARIABLE; }
 
 XVariable::XVariable(std::string idd, XDomainInteger* dom, std::vector<int> indexes) {
+    kind = EntityKind::VARIABLE;
     domain = dom;
+    index = -1;
     std::stringstream oss;
     oss << idd;
 
@@ -86,12 +78,11 @@ XVariable::XVariable(std::string idd, XDomainInteger* dom, std::vector<int> inde
 XVariable::~XVariable() {}
 
 XParameterVariable::XParameterVariable(std::string lid) : XVariable(lid, NULL) {
+    kind = EntityKind::PARAMETER;
     if (id[1] == '.')
         number = -1;
     else
         number = std::stoi(id.substr(1));
-    if (max < number)
-        max = number;
 }
 
 namespace XCSP3Core {
@@ -109,9 +100,8 @@ namespace XCSP3Core {
 // Check if a XEntity is an integer
 // If yes, the value is set to its integer
 bool XCSP3Core::isInteger(XEntity* xe, int& value) {
-    XInteger* xi;
-    if ((xi = dynamic_cast<XInteger*>(xe)) != NULL) {
-        value = xi->value;
+    if (xe != NULL && xe->kind == EntityKind::INTEGER) {
+        value = static_cast<XInteger*>(xe)->value;
         return true;
     }
     return false;
@@ -120,8 +110,8 @@ bool XCSP3Core::isInteger(XEntity* xe, int& value) {
 // Check if a XEntity is an integer
 // If yes, the value is set to its integer
 bool XCSP3Core::isInterval(XEntity* xe, int& min, int& max) {
-    XEInterval* xi;
-    if ((xi = dynamic_cast<XEInterval*>(xe)) != NULL) {
+    if (xe != NULL && xe->kind == EntityKind::INTERVAL) {
+        XEInterval* xi = static_cast<XEInterval*>(xe);
         min = xi->min;
         max = xi->max;
         return true;
@@ -130,15 +120,15 @@ bool XCSP3Core::isInterval(XEntity* xe, int& min, int& max) {
 }
 
 bool XCSP3Core::isVariable(XEntity* xe, XVariable*& v) {
-    XVariable* x;
-    if ((x = dynamic_cast<XVariable*>(xe)) != NULL) {
-        v = x;
+    if (xe != NULL && xe->isVariable()) {
+        v = static_cast<XVariable*>(xe);
         return true;
     }
     return false;
 }
 
 XVariableArray::XVariableArray(std::string id, std::vector<int> szs) : XEntity(id), sizes(szs.begin(), szs.end()) {
+    kind = EntityKind::ARRAY;
     int nb = 1;
     for (int sz : sizes)
         nb *= sz;
@@ -146,12 +136,13 @@ XVariableArray::XVariableArray(std::string id, std::vector<int> szs) : XEntity(i
 }
 
 XVariableArray::XVariableArray(std::string idd, XVariableArray* as) : sizes(as->sizes.begin(), as->sizes.end()) {
+    kind = EntityKind::ARRAY;
     std::vector<int> indexes;
     indexes.assign(as->sizes.size(), 0);
     variables.assign(as->variables.size(), NULL);
     id = idd;
     for (unsigned int i = 0; i < variables.size(); i++) {
-        variables[i] = DataPool::EntityPool.make<XVariable>(idd, as->variables[i]->domain, indexes);
+        variables[i] = DataPool::current().EntityPool.make<XVariable>(idd, as->variables[i]->domain, indexes);
         for (int j = sizes.size() - 1; j >= 0; j--)
             if (++indexes[j] == sizes[j])
                 indexes[j] = 0;
@@ -183,41 +174,80 @@ bool XVariableArray::incrementIndexes(std::vector<int>& indexes, std::vector<XIn
     return j >= 0;
 }
 
-void XVariableArray::getVarsFor(std::vector<XVariable*>& list, std::string compactForm, std::vector<int>* flatIndexes, bool storeIndexes) {
-    std::vector<XIntegerEntity*> ranges;
-    std::string tmp;
-    // Compute the different ranges for all dimension
-    for (unsigned int i = 0; i < sizes.size(); i++) {
-        int pos = compactForm.find(']');
-        tmp = compactForm.substr(1, pos - 1);
-        compactForm = compactForm.substr(pos + 1);
-        if (tmp.size() == 0) {
-            ranges.push_back(DataPool::IntegerEntityPool.make<XIntegerInterval>(0, sizes[i] - 1));
-        } else {
-            size_t dot = tmp.find("..");
-            if (dot == std::string::npos)
-                ranges.push_back(DataPool::IntegerEntityPool.make<XIntegerValue>(std::stoi(tmp)));
-            else {
-                int first = std::stoi(tmp.substr(0, dot));
-                int last = std::stoi(tmp.substr(dot + 2));
-                ranges.push_back(DataPool::IntegerEntityPool.make<XIntegerInterval>(first, last));
-            }
-        }
+// Read the range of one dimension of a compact form ("[]", "[3]" or "[2..7]") at p, without allocation
+static bool readRange(const char*& p, const char* end, int size, int& min, int& max) {
+    if (p == end || *p != '[')
+        return false;
+    p++;
+    if (p != end && *p == ']') {
+        p++;
+        min = 0;
+        max = size - 1;
+        return true;
+    }
+    for (int k = 0; k < 2; k++) {
+        long value = 0;
+        const char* digits = p;
+        for (; p != end && *p >= '0' && *p <= '9' && value <= size; p++)
+            value = value * 10 + (*p - '0');
+        if (p == digits)
+            return false;
+        max = static_cast<int>(value);
+        if (k == 0)
+            min = max;
+        if (p != end && *p == ']')
+            break;
+        if (k == 1 || end - p < 2 || p[0] != '.' || p[1] != '.')
+            return false;
+        p += 2;
+    }
+    p++;
+    return min <= max && max < size;
+}
+
+void XVariableArray::getVarsFor(std::vector<XVariable*>& list, const std::string& compactForm, std::vector<int>* flatIndexes, bool storeIndexes) {
+    // Ranges, strides and indexes are on the stack for arrays with at most 8 dimensions
+    const size_t n = sizes.size(), inlined = 8;
+    int stack[4 * inlined];
+    std::vector<int> heap;
+    if (n > inlined)
+        heap.resize(4 * n);
+    int* mins = n > inlined ? heap.data() : stack;
+    int* maxs = mins + n;
+    int* strides = maxs + n;
+    int* indexes = strides + n;
+
+    const char* p = compactForm.data();
+    const char* end = p + compactForm.size();
+    int flat = 0;
+    for (int i = n - 1, stride = 1; i >= 0; i--) {
+        strides[i] = stride;
+        stride *= sizes[i];
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (readRange(p, end, sizes[i], mins[i], maxs[i]) == false)
+            throw std::runtime_error("bad compact form: " + id + compactForm);
+        indexes[i] = mins[i];
+        flat += mins[i] * strides[i];
     }
-    // Compute the first one
-    std::vector<int> indexes;
-    for (unsigned int i = 0; i < sizes.size(); i++)
-        indexes.push_back(ranges[i]->minimum());
 
-    // Compute all necessary variables
+    // Same order as incrementIndexes, the flat index is updated with the strides
+    int j;
     do {
         if (storeIndexes)
-            flatIndexes->push_back(flatIndexFor(indexes));
-        else {
-            if (variables[flatIndexFor(indexes)] != nullptr)
-                list.push_back(variables[flatIndexFor(indexes)]);
+            flatIndexes->push_back(flat);
+        else if (variables[flat] != nullptr)
+            list.push_back(variables[flat]);
+        for (j = n - 1; j >= 0; j--) {
+            if (indexes[j] < maxs[j]) {
+                indexes[j]++;
+                flat += strides[j];
+                break;
+            }
+            flat -= (indexes[j] - mins[j]) * strides[j];
+            indexes[j] = mins[j];
         }
-    } while (incrementIndexes(indexes, ranges));
+    } while (j >= 0);
 }
 
 void XVariableArray::buildVarsWith(XDomainInteger* domain) {
@@ -226,7 +256,7 @@ void XVariableArray::buildVarsWith(XDomainInteger* domain) {
 
     for (unsigned int i = 0; i < variables.size(); i++) {
         if (variables[i] == NULL) // We need to create a variable
-            variables[i] = DataPool::EntityPool.make<XVariable>(id, domain, indexes);
+            variables[i] = DataPool::current().EntityPool.make<XVariable>(id, domain, indexes);
         for (int j = sizes.size() - 1; j >= 0; j--)
             if (++indexes[j] == sizes[j])
                 indexes[j] = 0;
@@ -235,7 +265,7 @@ void XVariableArray::buildVarsWith(XDomainInteger* domain) {
     }
 }
 
-int XVariableArray::flatIndexFor(std::vector<int> indexes) {
+int XVariableArray::flatIndexFor(const std::vector<int>& indexes) {
     int sum = 0;
     for (int i = indexes.size() - 1, nb = 1; i >= 0; i--) {
         sum += indexes[i] * nb;
@@ -244,6 +274,63 @@ int XVariableArray::flatIndexFor(std::vector<int> indexes) {
     return sum;
 }
 
+void XVariableArray::sliceFor(const std::string& compactForm, XArraySlice& slice) {
+    slice.array = this;
+    slice.ranges.clear();
+    slice.strides.assign(sizes.size(), 1);
+    for (int i = sizes.size() - 2; i >= 0; i--)
+        slice.strides[i] = slice.strides[i + 1] * sizes[i + 1];
+    const char* p = compactForm.data();
+    const char* end = p + compactForm.size();
+    for (unsigned int i = 0; i < sizes.size(); i++) {
+        int min, max;
+        if (readRange(p, end, sizes[i], min, max) == false)
+            throw std::runtime_error("bad compact form: " + id + compactForm);
+        slice.ranges.push_back(XInterval(min, max));
+    }
+}
+
+size_t XArraySlice::size() const {
+    if (array == nullptr)
+        return 0;
+    size_t nb = 1;
+    for (const XInterval& range : ranges)
+        nb *= range.max - range.min + 1;
+    return nb;
+}
+
+XArraySlice::iterator::iterator(const XArraySlice* s, bool end) : slice(s), flat(-1) {
+    if (end)
+        return;
+    flat = 0;
+    for (unsigned int i = 0; i < s->ranges.size(); i++) {
+        indexes_.push_back(s->ranges[i].min);
+        flat += s->ranges[i].min * s->strides[i];
+    }
+}
+
+XArraySlice::iterator& XArraySlice::iterator::operator++() {
+    // Same order as XVariableArray::incrementIndexes: the last dimension first
+    for (int j = indexes_.size() - 1; j >= 0; j--) {
+        const XInterval& range = slice->ranges[j];
+        if (indexes_[j] < range.max) {
+            indexes_[j]++;
+            flat += slice->strides[j];
+            return *this;
+        }
+        flat -= (indexes_[j] - range.min) * slice->strides[j];
+        indexes_[j] = range.min;
+    }
+    flat = -1;
+    return *this;
+}
+
+void XArraySlice::getVars(std::vector<XVariable*>& list) const {
+    for (iterator it = begin(); it != end(); ++it)
+        if (*it != nullptr)
+            list.push_back(*it);
+}
+
 //------------------------------------------------------------------------------------------
 //  XCSP3Variable.h functions
 //------------------------------------------------------------------------------------------
@@ -265,25 +352,45 @@ void XConstraintGroup::unfoldVector(std::vector<XVariable*>& toUnfold, std::vect
     XParameterVariable* xp;
     if (initial.size() == 0)
         return;
-    if ((xp = dynamic_cast<XParameterVariable*>(initial[0])) == NULL) { // non parametrized vector
+    if ((xp = isParameter(initial[0])) == NULL) { // non parametrized vector
         toUnfold.assign(initial.begin(), initial.end());
         return;
     }
     if (xp->number == -1) { // %...
-        toUnfold.assign(args.begin() + (XParameterVariable::max == -1 ? 0 : XParameterVariable::max + 1), args.end());
+        toUnfold.assign(args.begin() + (maxParameter == -1 ? 0 : maxParameter + 1), args.end());
         return;
     }
     for (XVariable* xv : initial) {
-        xp = dynamic_cast<XParameterVariable*>(xv);
-        toUnfold.push_back(args[xp->number]);
+        xp = isParameter(xv);
+        toUnfold.push_back(xp == NULL ? xv : args[xp->number]);
     }
 }
 
 void XConstraintGroup::unfoldString(std::string& toUnfold, std::vector<XVariable*>& args) {
-    for (int i = args.size() - 1; i >= 0; i--) {
-        std::string param = "%" + std::to_string(i);
-        ReplaceStringInPlace(toUnfold, param, args[i]->id);
+    // One pass: each %i is replaced by the argument i
+    // The buffer is per thread: rows of a group may be unfolded in parallel
+    static thread_local std::string unfolded;
+    unfolded.clear();
+    size_t i = 0, size = toUnfold.size();
+    while (i < size) {
+        size_t pos = toUnfold.find('%', i);
+        if (pos == std::string::npos)
+            pos = size;
+        unfolded.append(toUnfold, i, pos - i);
+        if (pos == size)
+            break;
+        size_t end = pos + 1;
+        unsigned long number = 0;
+        while (end < size && isdigit(toUnfold[end]) && number < args.size())
+            number = number * 10 + (toUnfold[end++] - '0');
+        if (end == pos + 1 || number >= args.size()) { // Not a parameter, keep it
+            end = pos + 1;
+            unfolded += '%';
+        } else
+            unfolded += args[number]->id;
+        i = end;
     }
+    toUnfold.assign(unfolded);
 }
 
 namespace XCSP3Core {
@@ -319,48 +426,105 @@ void XInitialCondition::unfoldParameters(XConstraintGroup* group, std::vector<XV
 }
 
 void XInitialCondition::extractCondition(XCondition& xc) { // Create the op and the operand (which can be a value, an interval or a XVariable)
-    std::regex const rglt(R"(\(.*(le|lt|ge|gt|in|eq|ne),(.*)\).*)");
-    std::smatch match;
-    std::regex_match(condition, match, rglt);
-
-    if (match.size() != 3)
+    if (parseCondition(condition, xc) == false)
         throw std::runtime_error("condition is malformed\n");
+}
 
-    xc.val = xc.min = xc.max = 0;
-    xc.var = "";
-    std::string tmp0 = match[1].str();
-    std::string tmp1 = match[2].str();
-
-    if (tmp0 == "le")
+static inline bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Read an integer that spans exactly [begin, end), false if it is not an integer or if it overflows
+static bool parseInteger(const char* begin, const char* end, int& value) {
+    bool negative = begin < end && (*begin == '-' || *begin == '+');
+    if (negative)
+        negative = *begin++ == '-';
+    if (begin == end)
+        return false;
+    long long v = 0;
+    for (; begin < end; begin++) {
+        if (*begin < '0' || *begin > '9')
+            return false;
+        v = v * 10 + (*begin - '0');
+        if (v > 2147483648LL)
+            return false;
+    }
+    v = negative ? -v : v;
+    if (v > 2147483647LL)
+        return false;
+    value = static_cast<int>(v);
+    return true;
+}
+
+// (op,operand) where operand is an integer, an interval min..max or a variable
+bool XInitialCondition::parseCondition(const std::string& condition, XCondition& xc) {
+    const char* begin = condition.data();
+    const char* end = begin + condition.size();
+    while (begin < end && *begin != '(')
+        begin++;
+    while (end > begin && *(end - 1) != ')')
+        end--;
+    if (end - begin < 2)
+        return false;
+    begin++; // skip the parentheses
+    end--;
+
+    const char* comma = begin;
+    while (comma < end && *comma != ',')
+        comma++;
+    if (comma == end)
+        return false;
+    const char* op = comma;
+    while (op > begin && isBlank(*(op - 1)))
+        op--;
+    if (op - begin < 2)
+        return false;
+    char o0 = *(op - 2), o1 = *(op - 1);
+    if (o0 == 'l' && o1 == 'e')
         xc.op = OrderType::LE;
-    if (tmp0 == "lt")
+    else if (o0 == 'l' && o1 == 't')
         xc.op = OrderType::LT;
-    if (tmp0 == "ge")
+    else if (o0 == 'g' && o1 == 'e')
         xc.op = OrderType::GE;
-    if (tmp0 == "gt")
+    else if (o0 == 'g' && o1 == 't')
         xc.op = OrderType::GT;
-    if (tmp0 == "in")
+    else if (o0 == 'i' && o1 == 'n')
         xc.op = OrderType::IN;
-    if (tmp0 == "eq")
+    else if (o0 == 'e' && o1 == 'q')
         xc.op = OrderType::EQ;
-    if (tmp0 == "ne")
+    else if (o0 == 'n' && o1 == 'e')
         xc.op = OrderType::NE;
-    //std::cout << condition <<": "<< tmp0 << " " <<tmp1 << std::endl;
-    //printf("%d %d\n",' ',condition[condition.length()-1]);
-    size_t dotdot = tmp1.find('.');
-    if (dotdot != std::string::npos) { // Normal variable
+    else
+        return false;
+
+    const char* operand = comma + 1;
+    while (operand < end && isBlank(*operand))
+        operand++;
+    while (end > operand && isBlank(*(end - 1)))
+        end--;
+
+    xc.val = xc.min = xc.max = 0;
+    xc.var.clear();
+    const char* dot = operand;
+    while (dot < end && *dot != '.')
+        dot++;
+    if (dot != end) { // An interval
+        if (end - dot < 2 || dot[1] != '.' || parseInteger(operand, dot, xc.min) == false || parseInteger(dot + 2, end, xc.max) == false)
+            return false;
         xc.operandType = OperandType::INTERVAL;
-        xc.min = stoi(tmp1.substr(0, dotdot));
-        xc.max = stoi(tmp1.substr(dotdot + 2));
-        return;
+        return true;
     }
-    try {
-        xc.val = stoi(tmp1);
+    if (operand < end && (isdigit(*operand) || *operand == '-' || *operand == '+')) { // Not a variable
+        if (parseInteger(operand, end, xc.val) == false)
+            return false;
         xc.operandType = OperandType::INTEGER;
-    } catch (const std::invalid_argument& e) {
-        xc.var = tmp1;
-        xc.operandType = OperandType::VARIABLE;
+        return true;
     }
+    if (operand == end)
+        return false;
+    xc.var.assign(operand, end);
+    xc.operandType = OperandType::VARIABLE;
+    return true;
 }
 
 void XValues::unfoldParameters(XConstraintGroup* group, std::vector<XVariable*>& arguments, XConstraint* original) {
@@ -371,7 +535,7 @@ void XValues::unfoldParameters(XConstraintGroup* group, std::vector<XVariable*>&
 void XValue::unfoldParameters(XConstraintGroup*, std::vector<XVariable*>& arguments, XConstraint* original) {
     XParameterVariable* xp;
     XValue* xv = dynamic_cast<XValue*>(original);
-    if ((xp = dynamic_cast<XParameterVariable*>(xv->value)) == NULL) {
+    if ((xp = isParameter(xv->value)) == NULL) {
         value = xv->value;
     } else
         value = arguments[xp->number == -1 ? 0 : xp->number];
@@ -382,7 +546,7 @@ void XIndex::unfoldParameters(XConstraintGroup*, std::vector<XVariable*>& argume
     XIndex* xi = dynamic_cast<XIndex*>(original);
     if (xi->index == NULL)
         return;
-    if ((xp = dynamic_cast<XParameterVariable*>(xi->index)) == NULL)
+    if ((xp = isParameter(xi->index)) == NULL)
         index = xi->index;
     else
         index = arguments[xp->number == -1 ? 0 : xp->number];
@@ -482,7 +646,7 @@ void XConstraintElementMatrix::unfoldParameters(XConstraintGroup* group, std::ve
     startColIndex = xc->startColIndex;
     startRowIndex = xc->startRowIndex;
     XParameterVariable* xp;
-    if ((xp = dynamic_cast<XParameterVariable*>(xc->index2)) == nullptr)
+    if ((xp = isParameter(xc->index2)) == nullptr)
         index2 = xc->index2;
     else
         index2 = arguments[xp->number == -1 ? 0 : xp->number];
@@ -531,11 +695,11 @@ void XConstraintClause::unfoldParameters(XConstraintGroup* group, std::vector<XV
     (void)group;
     (void)original;
     for (XVariable* xv : arguments) {
-        if (dynamic_cast<XTree*>(xv) != nullptr) { // not
+        if (xv->kind == EntityKind::TREE) { // not
             if (xv->id.rfind("not(", 0) != 0)
                 throw std::runtime_error("a clause is malformed in a group: " + xv->id);
             std::string name = xv->id.substr(4, xv->id.length() - 5);
-            negative.push_back(DataPool::EntityPool.make<XVariable>(name, nullptr)); // TODO: improvements needed here
+            negative.push_back(DataPool::current().EntityPool.make<XVariable>(name, nullptr)); // TODO: improvements needed here
         } else {
             positive.push_back(xv);
         }
@@ -24,6 +24,8 @@
  *=============================================================================
  */
 #include "XCSP3CoreParser.h"
+#include <cstdlib>
+#include <mutex>
 
 using namespace XCSP3Core;
 
@@ -36,6 +38,15 @@ namespace XCSP3Core {
     }
 } // namespace XCSP3Core
 
+// libxml2 is initialized once and cleaned at exit: xmlCleanupParser must not be called while other threads parse
+void XCSP3CoreParser::initLibxml() {
+    static std::once_flag once;
+    std::call_once(once, []() {
+        xmlInitParser();
+        std::atexit(xmlCleanupParser);
+    });
+}
+
 int XCSP3CoreParser::parse(const char* filename) {
     std::ifstream in(filename);
     if (!in.good())
@@ -43,6 +54,32 @@ int XCSP3CoreParser::parse(const char* filename) {
     return parse(in);
 }
 
+static const int bufSize = 4096;
+
+XCSP3CoreParser::XCSP3CoreParser(XCSP3CoreCallbacksBase* cb) : cspParser(cb), parserCtxt(nullptr), buffer(new char[bufSize]) {
+    initLibxml();
+    LIBXML_TEST_VERSION
+
+    xmlSAXVersion(&handler, 1); // use SAX1 for now ???
+
+    handler.startDocument = startDocument;
+    handler.endDocument = endDocument;
+    handler.characters = characters;
+    handler.startElement = startElement;
+    handler.endElement = endElement;
+    handler.comment = comment;
+}
+
+XCSP3CoreParser::~XCSP3CoreParser() {
+    if (parserCtxt)
+        xmlFreeParserCtxt(parserCtxt);
+}
+
+void XCSP3CoreParser::reset() {
+    cspParser.reset();
+    pool.reset();
+}
+
 int XCSP3CoreParser::parse(std::istream& in) {
     /**
      * We don't use the DOM interface because it reads the document as
@@ -55,23 +92,13 @@ int XCSP3CoreParser::parse(std::istream& in) {
      * We also use the push mode to be able to read from any C++
      * stream.
      */
+    DataPool::Use use(pool);
     const char* filename = NULL; // name of the input file
-    xmlSAXHandler handler;
-    xmlParserCtxtPtr parserCtxt = nullptr;
-
-    const int bufSize = 4096;
-    std::unique_ptr<char[]> buffer{new char[bufSize]};
 
     int size;
 
-    xmlSAXVersion(&handler, 1); // use SAX1 for now ???
-
-    handler.startDocument = startDocument;
-    handler.endDocument = endDocument;
-    handler.characters = characters;
-    handler.startElement = startElement;
-    handler.endElement = endElement;
-    handler.comment = comment;
+    if (parserCtxt == nullptr) // First parse, or the previous one was interrupted
+        reset();
 
     try {
         xmlSubstituteEntitiesDefault(1);
@@ -80,7 +107,10 @@ int XCSP3CoreParser::parse(std::istream& in) {
         size = in.gcount();
 
         if (size > 0) {
-            parserCtxt = xmlCreatePushParserCtxt(&handler, &cspParser, buffer.get(), size, filename);
+            if (parserCtxt == nullptr)
+                parserCtxt = xmlCreatePushParserCtxt(&handler, &cspParser, buffer.get(), size, filename);
+            else
+                xmlCtxtResetPush(parserCtxt, buffer.get(), size, filename, NULL);
 
             while (in.good()) {
                 in.read(buffer.get(), bufSize);
@@ -91,10 +121,6 @@ int XCSP3CoreParser::parse(std::istream& in) {
             }
 
             xmlParseChunk(parserCtxt, buffer.get(), 0, 1);
-
-            xmlFreeParserCtxt(parserCtxt);
-
-            xmlCleanupParser();
         }
     } catch (...) {
         // ???
@@ -102,9 +128,13 @@ int XCSP3CoreParser::parse(std::istream& in) {
             std::cout << "c Exception at line " << parserCtxt->input->line << std::endl;
         else
             std::cout << "c Exception at undefined line" << std::endl;
+        // The context is in an unknown state, the next parse starts with a new one and resets the parser
+        if (parserCtxt)
+            xmlFreeParserCtxt(parserCtxt);
+        parserCtxt = nullptr;
         throw;
     }
-    DataPool::clear();
+    reset();
     return 0;
 }
 
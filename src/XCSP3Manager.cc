@@ -29,12 +29,27 @@
 #include "XCSP3Objective.h"
 #include "XCSP3TreeNode.h"
 #include "XCSP3Variable.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <map>
-#include <regex>
 #include <string>
+#include <sstream>
+#include <thread>
+#include <utility>
 
 using namespace XCSP3Core;
 
+static const size_t PARALLEL_UNFOLDING_MIN_ROWS = 1024; // smaller groups are unfolded sequentially
+
+// The number of threads used to unfold groups: no more than the number of cores
+static size_t unfoldingThreads(int wanted) {
+    size_t cores = std::thread::hardware_concurrency();
+    if (wanted < 1)
+        return 1;
+    return cores == 0 ? wanted : std::min(static_cast<size_t>(wanted), cores);
+}
+
 static OrderType expressionTypeToOrderType(Expr e) {
     if (e == Expr::LE)
         return OrderType::LE;
@@ -257,14 +272,112 @@ public:
     }
 };
 
-bool XCSP3Manager::recognizePrimitives(std::string id, Tree* tree) {
-    for (PrimitivePattern* p : patterns)
-        if (p->setTarget(id, tree)->match())
-            return true;
-    return false;
+class PrimitiveCustom : public XCSP3Core::PrimitivePattern { // registered with XCSP3CoreCallbacksBase::addIntensionPattern
+public:
+    XIntensionPattern& user;
+
+    PrimitiveCustom(XCSP3Manager& m, XIntensionPattern& u) : PrimitivePattern(m, u.expression), user(u) {
+        if (user.anyOperatorAtRoot)
+            pattern.root->type = Expr::FAKEOP;
+    }
+
+    bool post() override {
+        std::vector<XVariable*> list;
+        for (std::string& s : variables)
+            list.push_back(static_cast<XVariable*>(manager.mapping[s]));
+        return user.post(id, canonized, operators, constants, list);
+    }
+};
+
+//--------------------------------------------------------------------------------------
+// Discrimination tree: each pattern is a path of (kind, arity) in prefix order.
+// FAKEOP matches any node with the same arity, a set (arity -1) matches any set of constants.
+//--------------------------------------------------------------------------------------
+
+struct XCSP3Core::PatternTrieNode {
+    Expr type;
+    int arity;
+    std::vector<PatternTrieNode*> children;
+    std::vector<int> patterns; // patterns ending here
+
+    PatternTrieNode(Expr t, int a) : type(t), arity(a) {}
+
+    ~PatternTrieNode() {
+        for (PatternTrieNode* n : children)
+            delete n;
+    }
+
+    PatternTrieNode* child(Expr t, int a) {
+        for (PatternTrieNode* n : children)
+            if (n->type == t && n->arity == a)
+                return n;
+        children.push_back(new PatternTrieNode(t, a));
+        return children.back();
+    }
+};
+
+static PatternTrieNode* addPatternNode(PatternTrieNode* trie, Node* node) {
+    if (node->type == Expr::SET)
+        return trie->child(Expr::SET, -1);
+    if (node->type == Expr::VAR || node->type == Expr::DECIMAL)
+        return trie->child(node->type, 0);
+    trie = trie->child(node->type, node->parameters.size());
+    for (Node* n : node->parameters)
+        trie = addPatternNode(trie, n);
+    return trie;
+}
+
+void XCSP3Manager::addToPatternTrie(int index) {
+    addPatternNode(patternTrie, patterns[index]->pattern.root)->patterns.push_back(index);
+}
+
+static unsigned int prefixOrder(Node* node, std::vector<Node*>& prefix, std::vector<unsigned int>& skip) {
+    unsigned int position = prefix.size();
+    prefix.push_back(node);
+    skip.push_back(0);
+    for (Node* n : node->parameters)
+        prefixOrder(n, prefix, skip);
+    skip[position] = prefix.size();
+    return position;
+}
+
+void XCSP3Manager::collectCandidates(PatternTrieNode* trie, unsigned int position) {
+    candidates.insert(candidates.end(), trie->patterns.begin(), trie->patterns.end());
+    if (position == prefix.size())
+        return;
+    Node* node = prefix[position];
+    for (PatternTrieNode* n : trie->children) {
+        if (n->type == Expr::FAKEOP) {
+            if (n->arity == static_cast<int>(node->parameters.size()))
+                collectCandidates(n, position + 1);
+        } else if (n->type == node->type) {
+            if (n->arity == -1) { // set of constants
+                bool constants = true;
+                for (Node* p : node->parameters)
+                    constants = constants && p->type == Expr::DECIMAL;
+                if (constants)
+                    collectCandidates(n, skip[position]);
+            } else if (n->arity == static_cast<int>(node->parameters.size()))
+                collectCandidates(n, position + 1);
+        }
+    }
+}
+
+int XCSP3Manager::recognizePrimitives(std::string id, Tree* tree) {
+    prefix.clear();
+    skip.clear();
+    candidates.clear();
+    prefixOrder(tree->root, prefix, skip);
+    collectCandidates(patternTrie, 0);
+    std::sort(candidates.begin(), candidates.end()); // Keep the order of the patterns
+    for (int i : candidates)
+        if (patterns[i]->setTarget(id, tree)->match())
+            return i;
+    return -1;
 }
 
 void XCSP3Manager::createPrimitivePatterns() {
+    NodeFactory::Suspend suspend; // The root of some patterns is modified
     patterns.push_back(new PrimitiveUnary1(*this));
     patterns.push_back(new PrimitiveUnary2(*this));
     patterns.push_back(new PrimitiveUnary3(*this));
@@ -274,11 +387,127 @@ void XCSP3Manager::createPrimitivePatterns() {
     patterns.push_back(new PrimitiveBinary3(*this));
     patterns.push_back(new PrimitiveTernary1(*this));
     patterns.push_back(new PrimitiveTernary2(*this));
+    for (XIntensionPattern& p : callback->intensionPatterns)
+        patterns.push_back(new PrimitiveCustom(*this, p));
+
+    patternTrie = new PatternTrieNode(Expr::UNDEF, 0);
+    for (unsigned int i = 0; i < patterns.size(); i++)
+        addToPatternTrie(i);
 }
 
 void XCSP3Manager::destroyPrimitivePatterns() {
     for (PrimitivePattern* p : patterns)
         delete p;
+    patterns.clear();
+    delete patternTrie;
+    patternTrie = nullptr;
+}
+
+//--------------------------------------------------------------------------------------
+// Cache of intension constraints equal up to a renaming of their variables.
+// Canonization only compares variable names (sort of symmetric operators...), so two expressions
+// with the same shape, the same constants and the same relative order of variable names
+// give the same canonized tree, up to the renaming.
+//--------------------------------------------------------------------------------------
+
+struct XCSP3Core::IntensionTemplate {
+    Node* canonized;        // canonized tree of the first occurrence
+    std::vector<int> slots; // position of each variable node of canonized, in prefix order
+    int primitive;          // index of the recognized primitive, -1 if none
+};
+
+// Replace each variable of the expression by its position (first occurrence order, as Tree::listOfVariables)
+// The relative order of the names is appended to the key.
+static void intensionShape(const std::string& function, std::string& key, std::vector<std::string>& variables) {
+    size_t start = function.find_first_not_of(" \t\n\r");
+    size_t end = function.find_last_not_of(" \t\n\r");
+    key.clear();
+    variables.clear();
+    if (start == std::string::npos)
+        return;
+    end++;
+    while (start < end) {
+        size_t pos = start;
+        while (pos < end && function[pos] != '(' && function[pos] != ')' && function[pos] != ',')
+            pos++;
+        if (pos < end && function[pos] == '(') // operator
+            key.append(function, start, pos - start);
+        else if (pos > start) { // constant or variable, as Tree::createBasicParameter
+            size_t i = start;
+            while (i < pos && isspace(function[i]))
+                i++;
+            size_t j = (i < pos && (function[i] == '-' || function[i] == '+')) ? i + 1 : i;
+            if (j < pos && isdigit(function[j])) {
+                while (j < pos && isdigit(function[j]))
+                    j++;
+                key += '#';
+                key.append(function, i, j - i);
+            } else {
+                std::string name(function, start, pos - start);
+                unsigned int position = 0;
+                while (position < variables.size() && variables[position] != name)
+                    position++;
+                if (position == variables.size())
+                    variables.push_back(name);
+                key += '$';
+                key += std::to_string(position);
+            }
+        }
+        if (pos < end)
+            key += function[pos];
+        start = pos + 1;
+    }
+
+    // Rank of each name: positions are sorted by name, names are not copied
+    std::vector<int> order(variables.size());
+    for (unsigned int i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&variables](int a, int b) { return variables[a] < variables[b]; });
+    std::vector<int> rank(variables.size());
+    for (unsigned int i = 0; i < order.size(); i++)
+        rank[order[i]] = i;
+    key += '|';
+    for (int r : rank) {
+        key += std::to_string(r);
+        key += ',';
+    }
+}
+
+// Position of each variable node of the tree, in prefix order (the order of bindIntensionTemplate)
+static void intensionSlots(Node* node, std::vector<std::string>& variables, std::vector<int>& slots) {
+    if (node->type == Expr::VAR) {
+        std::vector<std::string>::iterator it = std::find(variables.begin(), variables.end(), static_cast<NodeVariable*>(node)->var);
+        slots.push_back(it - variables.begin());
+        return;
+    }
+    for (Node* n : node->parameters)
+        intensionSlots(n, variables, slots);
+}
+
+// Copy of a canonized tree where each variable is replaced by the one at the same position
+static Node* bindIntensionTemplate(Node* node, const int*& slot, std::vector<std::string>& variables, std::vector<XVariable*>& xvariables) {
+    if (node->type == Expr::DECIMAL)
+        return createNodeConstant(static_cast<NodeConstant*>(node)->val);
+    if (node->type == Expr::VAR) {
+        int position = *slot++;
+        return createNodeVariable(variables[position], xvariables[position]);
+    }
+    std::vector<Node*> params;
+    params.reserve(node->parameters.size());
+    for (Node* n : node->parameters)
+        params.push_back(bindIntensionTemplate(n, slot, variables, xvariables));
+    return createNodeOperator(node->type, params);
+}
+
+static Node* bindIntensionTemplate(Node* node, std::vector<int>& slots, std::vector<std::string>& variables, std::vector<XVariable*>& xvariables) {
+    const int* slot = slots.data();
+    return bindIntensionTemplate(node, slot, variables, xvariables);
+}
+
+void XCSP3Manager::destroyIntensionTemplates() {
+    for (auto& entry : intensionTemplates)
+        delete entry.second;
+    intensionTemplates.clear();
 }
 
 void XCSP3Manager::buildVariable(XVariable* variable) {
@@ -313,26 +542,74 @@ void XCSP3Manager::buildVariableArray(XVariableArray* variable) {
 // Basic constraints
 //--------------------------------------------------------------------------------------
 
+//--------------------------------------------------------------------------------------
+// Classes to discard
+//--------------------------------------------------------------------------------------
+
+size_t XCSP3Manager::classId(const std::string& name) {
+    std::pair<std::unordered_map<std::string, size_t>::iterator, bool> p = classIds.insert(std::make_pair(name, classIds.size()));
+    if (p.second)
+        discardedIds.push_back(false);
+    return p.first->second;
+}
+
+void XCSP3Manager::compileClassFilter() {
+    discardedIds.assign(discardedIds.size(), false);
+    for (const std::string& c : callback->classesToDiscard)
+        discardedIds[classId(c)] = true;
+    nbCompiledClasses = callback->classesToDiscard.size();
+    classVerdicts.clear();
+}
+
+bool XCSP3Manager::classesDiscarded(const std::string& classes) {
+    if (callback->classesToDiscard.empty())
+        return false;
+    if (callback->classesToDiscard.size() != nbCompiledClasses)
+        compileClassFilter();
+    std::unordered_map<std::string, bool>::iterator verdict = classVerdicts.find(classes);
+    if (verdict != classVerdicts.end())
+        return verdict->second;
+
+    // Classes are separated by spaces, each one is compared as a whole (not as a substring)
+    bool discarded = false;
+    std::string name;
+    std::istringstream in(classes);
+    while (discarded == false && in >> name)
+        discarded = discardedIds[classId(name)];
+    classVerdicts[classes] = discarded;
+    return discarded;
+}
+
+bool XCSP3Manager::newConstraintSlice(ConstraintType type, XConstraint* constraint, XArraySlice& slice) {
+    if (discardedClasses(constraint->classes))
+        return true;
+    return callback->buildConstraintSlice(constraint->id, type, constraint, slice);
+}
+
 void XCSP3Manager::newConstraintExtension(XConstraintExtension* constraint) {
     if (discardedClasses(constraint->classes))
         return;
 
     if (constraint->list.size() == 1) {
-        std::vector<int> tuples;
+        std::vector<int>& tuples = intScratch;
+        tuples.clear();
         for (std::vector<int>& tpl : constraint->tuples)
             tuples.push_back(tpl[0]);
-        callback->buildConstraintExtension(constraint->id, constraint->list[0], tuples, constraint->isSupport,
-                                           constraint->containsStar);
-    } else
-        callback->buildConstraintExtension(constraint->id, constraint->list, constraint->tuples,
-                                           constraint->isSupport, constraint->containsStar);
+        callback->buildConstraintExtensionOwned(constraint->id, constraint->list[0], std::move(tuples), constraint->isSupport,
+                                                constraint->containsStar);
+    } else if (callback->_arguments == nullptr) // not in a group: the tuples are not given again
+        callback->buildConstraintExtensionOwned(constraint->id, constraint->list, std::move(constraint->tuples),
+                                                constraint->isSupport, constraint->containsStar);
+    else
+        callback->buildConstraintExtensionSpan(constraint->id, constraint->list, constraint->tuples,
+                                               constraint->isSupport, constraint->containsStar);
 }
 
 void XCSP3Manager::newConstraintExtensionAsLastOne(XConstraintExtension* constraint) {
     if (discardedClasses(constraint->classes))
         return;
-    callback->buildConstraintExtensionAs(constraint->id, constraint->list,
-                                         constraint->isSupport, constraint->containsStar);
+    callback->buildConstraintExtensionAsSpan(constraint->id, constraint->list,
+                                             constraint->isSupport, constraint->containsStar);
 }
 
 void XCSP3Manager::newConstraintIntension(XConstraintIntension* constraint) {
@@ -345,15 +622,81 @@ void XCSP3Manager::newConstraintIntension(XConstraintIntension* constraint) {
         return;
     }
 
-    //std::cout << "ROOT1= " << constraint->function << std::endl;
-    std::unique_ptr<Tree> tree(new Tree(constraint->function));
+    if (callback->cacheIntensionTemplates == false) {
+        postIntension(constraint->id, constraint->function, nullptr, nullptr);
+        return;
+    }
+
+    std::string key;
+    std::vector<std::string> variables;
+    std::vector<XVariable*> xvariables;
+    intensionShape(constraint->function, key, variables);
+    for (std::string& name : variables) {
+        auto it = mapping.find(name);
+        xvariables.push_back(it == mapping.end() || it->second->isVariable() == false ? nullptr : static_cast<XVariable*>(it->second));
+    }
+    auto it = intensionTemplates.find(key);
+    if (it != intensionTemplates.end())
+        postIntension(constraint->id, it->second, variables, xvariables);
+    else
+        // The template must survive the release of the constraint (releaseConstraints)
+        intensionTemplates[key] = postIntension(constraint->id, constraint->function, &variables, &xvariables, &templateNodes);
+}
+
+IntensionTemplate* XCSP3Manager::postIntension(const std::string& id, const std::string& function, std::vector<std::string>* variables,
+                                               std::vector<XVariable*>* xvariables, Pool<Node>* nodes) {
+    //std::cout << "ROOT1= " << function << std::endl;
+    std::unique_ptr<Tree> tree(new Tree(function, &mapping));
     tree->canonize();
 
+    IntensionTemplate* t = nullptr;
+    if (variables != nullptr) { // keep a copy: the callback may modify the tree
+        callback->_statistics.intensionCacheMisses++;
+        t = new IntensionTemplate();
+        intensionSlots(tree->root, *variables, t->slots);
+        if (nodes != nullptr) {
+            Pool<Node>* saved = Pool<Node>::staging;
+            NodeFactory* factory = NodeFactory::current;
+            Pool<Node>::staging = nodes;
+            if (callback->releaseConstraints)
+                NodeFactory::current = nullptr; // shared nodes may be released before the template
+            t->canonized = bindIntensionTemplate(tree->root, t->slots, *variables, *xvariables);
+            Pool<Node>::staging = saved;
+            NodeFactory::current = factory;
+        } else
+            t->canonized = bindIntensionTemplate(tree->root, t->slots, *variables, *xvariables);
+        t->primitive = -1;
+    }
+
     //std::cout << "ROOT2= " ; tree->prefixe();std::cout << std::endl;
-    if (callback->recognizeSpecialIntensionCases && recognizePrimitives(constraint->id, tree.get()))
+    if (callback->recognizeSpecialIntensionCases) {
+        int primitive = recognizePrimitives(id, tree.get());
+        if (t != nullptr)
+            t->primitive = primitive;
+        if (primitive != -1)
+            return t;
+    }
+
+    callback->buildConstraintIntension(id, tree.get());
+    return t;
+}
+
+void XCSP3Manager::postIntension(const std::string& id, Tree* tree) {
+    if (callback->recognizeSpecialIntensionCases && recognizePrimitives(id, tree) != -1)
         return;
+    callback->buildConstraintIntension(id, tree);
+}
 
-    callback->buildConstraintIntension(constraint->id, tree.get());
+void XCSP3Manager::postIntension(const std::string& id, IntensionTemplate* t, std::vector<std::string>& variables, std::vector<XVariable*>& xvariables) {
+    callback->_statistics.intensionCacheHits++;
+    Tree tree(bindIntensionTemplate(t->canonized, t->slots, variables, xvariables));
+    tree.listOfVariables = variables;
+    if (t->primitive != -1 && patterns[t->primitive]->setTarget(id, &tree)->match())
+        return;
+    // User patterns may depend on the variables themselves, try them again
+    if (callback->recognizeSpecialIntensionCases && callback->intensionPatterns.size() > 0 && recognizePrimitives(id, &tree) != -1)
+        return;
+    callback->buildConstraintIntension(id, &tree);
 }
 
 //--------------------------------------------------------------------------------------
@@ -363,14 +706,21 @@ void XCSP3Manager::newConstraintIntension(XConstraintIntension* constraint) {
 void XCSP3Manager::newConstraintRegular(XConstraintRegular* constraint) {
     if (discardedClasses(constraint->classes))
         return;
-    callback->buildConstraintRegular(constraint->id, constraint->list, constraint->start, constraint->final,
-                                     constraint->transitions);
+    if (callback->_arguments == nullptr) // not in a group: the transitions are not shared with other rows
+        callback->buildConstraintRegularOwned(constraint->id, constraint->list, constraint->start, constraint->final,
+                                              std::move(constraint->transitions));
+    else
+        callback->buildConstraintRegular(constraint->id, constraint->list, constraint->start, constraint->final,
+                                         constraint->transitions);
 }
 
 void XCSP3Manager::newConstraintMDD(XConstraintMDD* constraint) {
     if (discardedClasses(constraint->classes))
         return;
-    callback->buildConstraintMDD(constraint->id, constraint->list, constraint->transitions);
+    if (callback->_arguments == nullptr) // not in a group: the transitions are not shared with other rows
+        callback->buildConstraintMDDOwned(constraint->id, constraint->list, std::move(constraint->transitions));
+    else
+        callback->buildConstraintMDD(constraint->id, constraint->list, constraint->transitions);
 }
 
 //--------------------------------------------------------------------------------------
@@ -379,24 +729,23 @@ void XCSP3Manager::newConstraintMDD(XConstraintMDD* constraint) {
 
 void XCSP3Manager::containsTrees(std::vector<XVariable*>& list, std::vector<Tree*>& trees) {
     trees.clear();
-    XTree* xt = nullptr;
+    bool found = false;
     for (XVariable* x : list) {
-        xt = dynamic_cast<XTree*>(x);
-        if (xt != nullptr) { // The list contains at least one tree. Transform in list of trees
+        if (x->kind == EntityKind::TREE) { // The list contains at least one tree. Transform in list of trees
+            found = true;
             break;
         }
     }
-    if (xt == nullptr)
+    if (found == false)
         return;
 
     for (XVariable* x : list) {
-        xt = dynamic_cast<XTree*>(x);
-        if (xt != nullptr) { // The list contains at least one tree. Transform in list of trees
-            Tree* t = new Tree(xt->id);
+        if (x->kind == EntityKind::TREE) { // The list contains at least one tree. Transform in list of trees
+            Tree* t = new Tree(x->id, &mapping);
             t->canonize();
             trees.push_back(t);
         } else {
-            Tree* t = new Tree(x->id);
+            Tree* t = new Tree(x->id, &mapping);
             trees.push_back(t);
         }
     }
@@ -440,7 +789,8 @@ void XCSP3Manager::newConstraintOrdered(XConstraintOrdered* constraint) {
     if (discardedClasses(constraint->classes))
         return;
     if (constraint->lengths.size() > 0) {
-        std::vector<int> lengths;
+        std::vector<int>& lengths = intScratch;
+        lengths.clear();
         for (XVariable* x : constraint->lengths)
             lengths.push_back((static_cast<XInteger*>(x))->value);
         callback->buildConstraintOrdered(constraint->id, constraint->list, lengths, constraint->op);
@@ -503,7 +853,8 @@ void XCSP3Manager::newConstraintSum(XConstraintSum* constraint) {
         if (constraint->values.size() == 0)
             callback->buildConstraintSum(constraint->id, trees, xc);
         else {
-            std::vector<int> coefs;
+            std::vector<int>& coefs = intScratch;
+            coefs.clear();
             int v;
             for (XEntity* xe : constraint->values) {
                 isInteger(xe, v);
@@ -534,8 +885,9 @@ void XCSP3Manager::newConstraintSum(XConstraintSum* constraint) {
 
     int v;
     if (isInteger(constraint->values[0], v)) {
-        std::vector<int> coefs;
-        std::vector<XVariable*> list;
+        std::vector<int>& coefs = intScratch;
+        std::vector<XVariable*>& list = varScratch;
+        coefs.clear();
         for (XEntity* xe : constraint->values) {
             isInteger(xe, v);
             coefs.push_back(v);
@@ -545,11 +897,12 @@ void XCSP3Manager::newConstraintSum(XConstraintSum* constraint) {
         if (callback->normalizeSum)
             normalizeSum(list, coefs);
 
-        callback->buildConstraintSum(constraint->id, list, coefs, xc);
+        callback->buildConstraintSumOwned(constraint->id, list, std::move(coefs), xc);
         return;
     }
 
-    std::vector<XVariable*> xvalues;
+    std::vector<XVariable*>& xvalues = varScratch;
+    xvalues.clear();
     for (XEntity* xe : constraint->values) {
         xvalues.push_back(static_cast<XVariable*>(mapping[xe->id]));
     }
@@ -562,7 +915,8 @@ void XCSP3Manager::newConstraintCount(XConstraintCount* constraint) {
     int value;
     XCondition xc;
     constraint->extractCondition(xc);
-    std::vector<int> values;
+    std::vector<int>& values = intScratch;
+    values.clear();
 
     // One integer value
     // Special cases AtLeastK, ATMostK, ..
@@ -612,7 +966,8 @@ void XCSP3Manager::newConstraintCount(XConstraintCount* constraint) {
         }
         callback->buildConstraintCount(constraint->id, constraint->list, values, xc);
     } else {
-        std::vector<XVariable*> values;
+        std::vector<XVariable*>& values = varScratch;
+        values.clear();
         for (XEntity* xe : constraint->values) {
             values.push_back(static_cast<XVariable*>(mapping[xe->id]));
         }
@@ -655,8 +1010,10 @@ void XCSP3Manager::newConstraintNValues(XConstraintNValues* constraint) {
 void XCSP3Manager::newConstraintCardinality(XConstraintCardinality* constraint) {
     if (discardedClasses(constraint->classes))
         return;
-    std::vector<int> intValues;
-    std::vector<XVariable*> varValues;
+    std::vector<int>& intValues = intScratch;
+    std::vector<XVariable*>& varValues = varScratch;
+    intValues.clear();
+    varValues.clear();
     int v;
     for (XEntity* xe : constraint->values) {
         if (isInteger(xe, v))
@@ -667,9 +1024,12 @@ void XCSP3Manager::newConstraintCardinality(XConstraintCardinality* constraint)
         }
     }
 
-    std::vector<int> intOccurs;
-    std::vector<XVariable*> varOccurs;
-    std::vector<XInterval> intervalOccurs;
+    std::vector<int>& intOccurs = intScratch2;
+    std::vector<XVariable*>& varOccurs = varScratch2;
+    std::vector<XInterval>& intervalOccurs = intervalScratch;
+    intOccurs.clear();
+    varOccurs.clear();
+    intervalOccurs.clear();
 
     for (XEntity* xe : constraint->occurs) {
         if (isInteger(xe, v))
@@ -686,27 +1046,27 @@ void XCSP3Manager::newConstraintCardinality(XConstraintCardinality* constraint)
     }
 
     if (intValues.size() > 0 && intOccurs.size() > 0) {
-        callback->buildConstraintCardinality(constraint->id, constraint->list, intValues, intOccurs, constraint->closed);
+        callback->buildConstraintCardinalityIntIntSpan(constraint->id, constraint->list, intValues, intOccurs, constraint->closed);
         return;
     }
     if (intValues.size() > 0 && varOccurs.size() > 0) {
-        callback->buildConstraintCardinality(constraint->id, constraint->list, intValues, varOccurs, constraint->closed);
+        callback->buildConstraintCardinalityIntVarSpan(constraint->id, constraint->list, intValues, varOccurs, constraint->closed);
         return;
     }
     if (intValues.size() > 0 && intervalOccurs.size() > 0) {
-        callback->buildConstraintCardinality(constraint->id, constraint->list, intValues, intervalOccurs, constraint->closed);
+        callback->buildConstraintCardinalityIntIntervalSpan(constraint->id, constraint->list, intValues, intervalOccurs, constraint->closed);
         return;
     }
     if (varValues.size() > 0 && intOccurs.size() > 0) {
-        callback->buildConstraintCardinality(constraint->id, constraint->list, varValues, intOccurs, constraint->closed);
+        callback->buildConstraintCardinalityVarIntSpan(constraint->id, constraint->list, varValues, intOccurs, constraint->closed);
         return;
     }
     if (varValues.size() > 0 && varOccurs.size() > 0) {
-        callback->buildConstraintCardinality(constraint->id, constraint->list, varValues, varOccurs, constraint->closed);
+        callback->buildConstraintCardinalityVarVarSpan(constraint->id, constraint->list, varValues, varOccurs, constraint->closed);
         return;
     }
     if (varValues.size() > 0 && intervalOccurs.size() > 0) {
-        callback->buildConstraintCardinality(constraint->id, constraint->list, varValues, intervalOccurs, constraint->closed);
+        callback->buildConstraintCardinalityVarIntervalSpan(constraint->id, constraint->list, varValues, intervalOccurs, constraint->closed);
         return;
     }
 }
@@ -852,8 +1212,10 @@ void XCSP3Manager::newConstraintNoOverlap(XConstraintNoOverlap* constraint) {
     }
 
     int v;
-    std::vector<int> intLengths;
-    std::vector<XVariable*> varLengths;
+    std::vector<int>& intLengths = intScratch;
+    std::vector<XVariable*>& varLengths = varScratch;
+    intLengths.clear();
+    varLengths.clear();
 
     for (XEntity* xe : constraint->lengths) {
         if (isInteger(xe, v))
@@ -911,8 +1273,10 @@ void XCSP3Manager::newConstraintCumulative(XConstraintCumulative* constraint) {
     if (discardedClasses(constraint->classes))
         return;
     int v;
-    std::vector<int> intLengths;
-    std::vector<XVariable*> varLengths;
+    std::vector<int>& intLengths = intScratch;
+    std::vector<XVariable*>& varLengths = varScratch;
+    intLengths.clear();
+    varLengths.clear();
 
     for (XEntity* xe : constraint->lengths) {
         if (isInteger(xe, v))
@@ -923,8 +1287,10 @@ void XCSP3Manager::newConstraintCumulative(XConstraintCumulative* constraint) {
         }
     }
 
-    std::vector<int> intHeights;
-    std::vector<XVariable*> varHeights;
+    std::vector<int>& intHeights = intScratch2;
+    std::vector<XVariable*>& varHeights = varScratch2;
+    intHeights.clear();
+    varHeights.clear();
 
     for (XEntity* xe : constraint->heights) {
         if (isInteger(xe, v))
@@ -1001,6 +1367,17 @@ void XCSP3Manager::newConstraintCircuit(XConstraintCircuit* constraint) {
 // group constraints
 //--------------------------------------------------------------------------------------
 
+// Canonized tree of an unfolded intensional row, the other rows have none
+static Tree* rowTree(XConstraintIntension* constraint, std::map<std::string, XEntity*>* mapping) {
+    Tree* tree = new Tree(constraint->function, mapping);
+    tree->canonize();
+    return tree;
+}
+
+static Tree* rowTree(XConstraint*, std::map<std::string, XEntity*>*) {
+    return nullptr;
+}
+
 template <class T>
 void XCSP3Manager::unfoldConstraint(XConstraintGroup* group, int i, void (XCSP3Manager::*newConstraint)(T*)) {
     T* constraint = new T(group->constraint->id, group->constraint->classes);
@@ -1009,6 +1386,255 @@ void XCSP3Manager::unfoldConstraint(XConstraintGroup* group, int i, void (XCSP3M
     delete constraint;
 }
 
+// Rows are unfolded by workers taking chunks of consecutive rows (intensional constraints are also parsed and canonized).
+// They are kept in a circular window and posted here, in the order of the rows: callbacks are only called by this thread.
+template <class T>
+void XCSP3Manager::unfoldConstraintsInParallel(XConstraintGroup* group, void (XCSP3Manager::*newConstraint)(T*)) {
+    struct Row {
+        T* constraint;
+        Tree* tree;
+        std::exception_ptr error;
+        std::atomic<bool> ready;
+        Row() : constraint(nullptr), tree(nullptr), ready(false) {}
+    };
+    const size_t chunk = 64;
+    const size_t nbThreads = unfoldingThreads(callback->unfoldingThreads);
+    const size_t window = chunk * 16 * nbThreads;
+    const size_t nbRows = group->arguments.size();
+    bool trees = group->type == ConstraintType::INTENSION && callback->intensionUsingString == false;
+
+    std::unique_ptr<Row[]> rows(new Row[window]);
+    std::atomic<size_t> next(0), posted(0);
+    std::atomic<bool> stop(false);
+    std::vector<std::unique_ptr<Pool<Node>>> nodes;
+    std::vector<std::unique_ptr<Pool<XEntity>>> entities;
+    for (size_t w = 0; w < nbThreads; w++) {
+        nodes.emplace_back(new Pool<Node>(false));
+        entities.emplace_back(new Pool<XEntity>(false));
+    }
+
+    DataPool& context = DataPool::current();
+    auto worker = [&](size_t w) {
+        DataPool::Use use(context);
+        Pool<Node>::staging = nodes[w].get();
+        Pool<XEntity>::staging = entities[w].get();
+        for (;;) {
+            size_t first = next.fetch_add(chunk);
+            if (first >= nbRows)
+                break;
+            size_t last = std::min(first + chunk, nbRows);
+            while (last > posted.load(std::memory_order_acquire) + window && stop.load() == false)
+                std::this_thread::yield();
+            if (stop.load())
+                break;
+            for (size_t i = first; i < last; i++) {
+                Row& row = rows[i % window];
+                try {
+                    row.constraint = new T(group->constraint->id, group->constraint->classes);
+                    group->unfoldArgumentNumber(i, row.constraint);
+                    if (trees)
+                        row.tree = rowTree(row.constraint, &mapping);
+                } catch (...) {
+                    row.error = std::current_exception();
+                }
+                row.ready.store(true, std::memory_order_release);
+            }
+        }
+        Pool<Node>::staging = nullptr;
+        Pool<XEntity>::staging = nullptr;
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t w = 0; w < nbThreads; w++)
+        threads.emplace_back(worker, w);
+
+    auto finish = [&]() {
+        stop.store(true);
+        for (std::thread& thread : threads)
+            thread.join();
+        for (size_t w = 0; w < nbThreads; w++) {
+            DataPool::current().NodePool.adopt(*nodes[w]);
+            DataPool::current().EntityPool.adopt(*entities[w]);
+        }
+        for (size_t i = 0; i < window; i++) { // rows unfolded but not posted
+            delete rows[i].constraint;
+            delete rows[i].tree;
+        }
+    };
+
+    try {
+        for (size_t i = 0; i < nbRows; i++) {
+            Row& row = rows[i % window];
+            while (row.ready.load(std::memory_order_acquire) == false)
+                std::this_thread::yield();
+            if (row.error)
+                std::rethrow_exception(row.error);
+            if (trees == false)
+                (this->*newConstraint)(row.constraint);
+            else if (discardedClasses(row.constraint->classes) == false)
+                postIntension(row.constraint->id, row.tree);
+            delete row.constraint;
+            delete row.tree;
+            row.constraint = nullptr;
+            row.tree = nullptr;
+            row.ready.store(false, std::memory_order_relaxed);
+            posted.store(i + 1, std::memory_order_release);
+        }
+    } catch (...) {
+        finish();
+        throw;
+    }
+    finish();
+}
+
+// The template of the group is parsed once by shape: for each row, its variables (arguments or not) are ordered and compared,
+// rows with the same order and the same integer arguments share the canonized tree of the first one (see intensionShape).
+// Integers are part of the shape because canonization and primitives depend on constants (add(x,0), x + k op y...).
+void XCSP3Manager::newConstraintIntensionGroup(XConstraintGroup* group) {
+    XConstraintIntension* constraint = static_cast<XConstraintIntension*>(group->constraint);
+    if (discardedClasses(constraint->classes))
+        return;
+
+    std::string key;
+    std::vector<std::string> names; // variables of the template, in order of first occurrence
+    intensionShape(constraint->function, key, names);
+    std::vector<int> parameters; // the argument related to each name, -1 if it is a variable
+    std::vector<XVariable*> fixed;
+    for (std::string& name : names) {
+        int p = -1;
+        if (name.size() > 1 && name[0] == '%') {
+            if (name.find_first_not_of("0123456789", 1) != std::string::npos)
+                p = -2; // %... is not handled
+            else
+                p = std::stoi(name.substr(1));
+        }
+        parameters.push_back(p);
+        auto it = mapping.find(name);
+        fixed.push_back(p != -1 || it == mapping.end() || it->second->isVariable() == false ? nullptr : static_cast<XVariable*>(it->second));
+    }
+
+    std::map<std::vector<int>, std::unique_ptr<IntensionTemplate>> templates;
+    std::vector<int> order;
+    std::vector<std::string> variables, sorted;
+    std::vector<XVariable*> xvariables;
+    for (unsigned int i = 0; i < group->arguments.size(); i++) {
+        std::vector<XVariable*>& args = group->arguments[i];
+        bool compiled = true;
+        variables.clear();
+        xvariables.clear();
+        order.clear();
+        for (unsigned int j = 0; j < names.size() && compiled; j++) {
+            int p = parameters[j];
+            // Only true variables can be bound, integers are in the key, other arguments (trees...) change the shape
+            compiled = p < static_cast<int>(args.size()) && (p < 0 ? p == -1 : args[p]->index >= 0 || args[p]->kind == EntityKind::INTEGER);
+            if (compiled == false)
+                break;
+            if (p >= 0 && args[p]->kind == EntityKind::INTEGER) {
+                order.push_back(-1);
+                order.push_back(static_cast<XInteger*>(args[p])->value);
+                continue;
+            }
+            XVariable* x = p == -1 ? fixed[j] : args[p];
+            const std::string& name = p == -1 ? names[j] : x->id;
+            unsigned int position = std::find(variables.begin(), variables.end(), name) - variables.begin();
+            if (position == variables.size()) {
+                variables.push_back(name);
+                xvariables.push_back(x);
+            }
+            order.push_back(position);
+        }
+        if (compiled == false) {
+            unfoldConstraint<XConstraintIntension>(group, i, &XCSP3Manager::newConstraintIntension);
+            continue;
+        }
+        sorted.assign(variables.begin(), variables.end());
+        std::sort(sorted.begin(), sorted.end());
+        order.push_back(-2); // end of the arguments: the ranks of the names follow
+        for (std::string& name : variables)
+            order.push_back(std::lower_bound(sorted.begin(), sorted.end(), name) - sorted.begin());
+
+        auto it = templates.find(order);
+        if (it != templates.end()) {
+            postIntension(constraint->id, it->second.get(), variables, xvariables);
+            continue;
+        }
+        std::string function(constraint->function);
+        group->unfoldString(function, args);
+        templates[order].reset(postIntension(constraint->id, function, &variables, &xvariables));
+    }
+}
+
+// Give the template and the arguments (as a flat matrix) to the callback, return true if it handles the group
+bool XCSP3Manager::buildConstraintGroup(XConstraintGroup* group) {
+    std::vector<std::vector<XVariable*>>& arguments = group->arguments;
+    int arity = arguments.size() > 0 ? arguments[0].size() : 0;
+    std::vector<XVariable*> matrix;
+    matrix.reserve(arguments.size() * arity);
+    for (std::vector<XVariable*>& row : arguments) {
+        if (static_cast<int>(row.size()) != arity)
+            return false;
+        matrix.insert(matrix.end(), row.begin(), row.end());
+    }
+
+    if (group->type == ConstraintType::INTENSION && callback->intensionUsingString == false) {
+        // Fixed variables of the template are bound, parameters (%i) are not variables and stay unbound
+        Tree tree(static_cast<XConstraintIntension*>(group->constraint)->function, &mapping);
+        if (callback->buildConstraintGroup(group->id, &tree, matrix, arity))
+            return true;
+    }
+    return callback->buildConstraintGroup(group->id, group->type, group->constraint, matrix, arity);
+}
+
+// Extension groups are not concerned: their rows depend on the previous ones (same domains)
+void XCSP3Manager::unfoldGroupInParallel(XConstraintGroup* group) {
+    if (group->type == ConstraintType::INTENSION)
+        unfoldConstraintsInParallel<XConstraintIntension>(group, &XCSP3Manager::newConstraintIntension);
+    if (group->type == ConstraintType::CLAUSE)
+        unfoldConstraintsInParallel<XConstraintClause>(group, &XCSP3Manager::newConstraintClause);
+    if (group->type == ConstraintType::INSTANTIATION)
+        unfoldConstraintsInParallel<XConstraintInstantiation>(group, &XCSP3Manager::newConstraintInstantiation);
+    if (group->type == ConstraintType::ALLDIFF)
+        unfoldConstraintsInParallel<XConstraintAllDiff>(group, &XCSP3Manager::newConstraintAllDiff);
+    if (group->type == ConstraintType::ALLEQUAL)
+        unfoldConstraintsInParallel<XConstraintAllEqual>(group, &XCSP3Manager::newConstraintAllEqual);
+    if (group->type == ConstraintType::SUM)
+        unfoldConstraintsInParallel<XConstraintSum>(group, &XCSP3Manager::newConstraintSum);
+    if (group->type == ConstraintType::ORDERED)
+        unfoldConstraintsInParallel<XConstraintOrdered>(group, &XCSP3Manager::newConstraintOrdered);
+    if (group->type == ConstraintType::COUNT)
+        unfoldConstraintsInParallel<XConstraintCount>(group, &XCSP3Manager::newConstraintCount);
+    if (group->type == ConstraintType::NVALUES)
+        unfoldConstraintsInParallel<XConstraintNValues>(group, &XCSP3Manager::newConstraintNValues);
+    if (group->type == ConstraintType::CARDINALITY)
+        unfoldConstraintsInParallel<XConstraintCardinality>(group, &XCSP3Manager::newConstraintCardinality);
+    if (group->type == ConstraintType::MAXIMUM)
+        unfoldConstraintsInParallel<XConstraintMaximum>(group, &XCSP3Manager::newConstraintMaximum);
+    if (group->type == ConstraintType::MINIMUM)
+        unfoldConstraintsInParallel<XConstraintMinimum>(group, &XCSP3Manager::newConstraintMinimum);
+    if (group->type == ConstraintType::ELEMENT)
+        unfoldConstraintsInParallel<XConstraintElement>(group, &XCSP3Manager::newConstraintElement);
+    if (group->type == ConstraintType::ELEMENTMATRIX)
+        unfoldConstraintsInParallel<XConstraintElementMatrix>(group, &XCSP3Manager::newConstraintElementMatrix);
+    if (group->type == ConstraintType::NOOVERLAP)
+        unfoldConstraintsInParallel<XConstraintNoOverlap>(group, &XCSP3Manager::newConstraintNoOverlap);
+    if (group->type == ConstraintType::STRETCH)
+        unfoldConstraintsInParallel<XConstraintStretch>(group, &XCSP3Manager::newConstraintStretch);
+    if (group->type == ConstraintType::LEX)
+        unfoldConstraintsInParallel<XConstraintLex>(group, &XCSP3Manager::newConstraintLex);
+    if (group->type == ConstraintType::CHANNEL)
+        unfoldConstraintsInParallel<XConstraintChannel>(group, &XCSP3Manager::newConstraintChannel);
+    if (group->type == ConstraintType::REGULAR)
+        unfoldConstraintsInParallel<XConstraintRegular>(group, &XCSP3Manager::newConstraintRegular);
+    if (group->type == ConstraintType::MDD)
+        unfoldConstraintsInParallel<XConstraintMDD>(group, &XCSP3Manager::newConstraintMDD);
+    if (group->type == ConstraintType::CIRCUIT)
+        unfoldConstraintsInParallel<XConstraintCircuit>(group, &XCSP3Manager::newConstraintCircuit);
+    if (group->type == ConstraintType::CUMULATIVE)
+        unfoldConstraintsInParallel<XConstraintCumulative>(group, &XCSP3Manager::newConstraintCumulative);
+    if (group->type == ConstraintType::UNKNOWN)
+        throw std::runtime_error("Group constraint is badly defined");
+}
+
 void XCSP3Manager::newConstraintGroup(XConstraintGroup* group) {
     if (discardedClasses(group->classes))
         return;
@@ -1016,6 +1642,23 @@ void XCSP3Manager::newConstraintGroup(XConstraintGroup* group) {
     std::vector<XVariable*> previousArguments; // Used to check if extension arguments have same domains
     callback->_arguments = &(group->arguments);
 
+    if (callback->nativeConstraintGroups && discardedClasses(group->constraint->classes) == false && buildConstraintGroup(group)) {
+        callback->_arguments = nullptr;
+        return;
+    }
+
+    if (group->type == ConstraintType::INTENSION && callback->cacheIntensionTemplates && callback->intensionUsingString == false) {
+        newConstraintIntensionGroup(group);
+        callback->_arguments = nullptr;
+        return;
+    }
+
+    if (unfoldingThreads(callback->unfoldingThreads) > 1 && group->arguments.size() >= PARALLEL_UNFOLDING_MIN_ROWS && group->type != ConstraintType::EXTENSION) {
+        unfoldGroupInParallel(group);
+        callback->_arguments = nullptr;
+        return;
+    }
+
     for (unsigned int i = 0; i < group->arguments.size(); i++) {
         if (group->type == ConstraintType::INTENSION)
             unfoldConstraint<XConstraintIntension>(group, i, &XCSP3Manager::newConstraintIntension);
@@ -3,22 +3,116 @@
 #include "XCSP3Objective.h"
 #include "XCSP3Variable.h"
 #include "XCSP3Constraint.h"
-#include "XCSP3TreeNode.h" 
+#include "XCSP3TreeNode.h"
+#include <mutex>
 
 namespace XCSP3Core {
-    Pool<XEntity> DataPool::EntityPool;
-    Pool<XIntegerEntity> DataPool::IntegerEntityPool;
-    Pool<XDomain> DataPool::DomainPool;
-    Pool<XConstraint> DataPool::ConstraintPool;
-    Pool<XObjective> DataPool::ObjectivePool;
-    Pool<Node> DataPool::NodePool;
+    thread_local DataPool* DataPool::inUse = nullptr;
+
+    static const std::string& emptyString() {
+        static const std::string empty;
+        return empty;
+    }
+
+    size_t StringTable::slotOf(const std::string& s) const {
+        size_t mask = table.size() - 1;
+        size_t slot = std::hash<std::string>()(s) & mask;
+        while (table[slot] != nullptr && *table[slot] != s)
+            slot = (slot + 1) & mask;
+        return slot;
+    }
+
+    const std::string* StringTable::intern(const std::string& s) {
+        if (s.empty())
+            return &emptyString();
+        if (2 * (strings.size() + 1) > table.size()) {
+            // Strings are inserted again in their order, so the most recent ones are always the last of their probe sequence
+            table.assign(table.empty() ? 64 : 2 * table.size(), nullptr);
+            for (const std::string& x : strings)
+                table[slotOf(x)] = &x;
+        }
+        size_t slot = slotOf(s);
+        if (table[slot] == nullptr) {
+            strings.push_back(s);
+            table[slot] = &strings.back();
+        }
+        return table[slot];
+    }
+
+    void StringTable::rewind(size_t m) {
+        // From the most recent: nothing was inserted after them, their slots can be emptied
+        while (strings.size() > m) {
+            table[slotOf(strings.back())] = nullptr;
+            strings.pop_back();
+        }
+    }
+
+    void StringTable::clear() {
+        strings.clear();
+        table.clear();
+    }
+
+    XString::XString() : s(&emptyString()) {}
+
+    XString::XString(const std::string& str) : s(DataPool::intern(str)) {}
+
+    XString::XString(const char* str) : s(DataPool::intern(str)) {}
+
+    const std::string* DataPool::intern(const std::string& s) {
+        if (inUse != nullptr) // only the thread which parses interns in the pools of its parse
+            return inUse->StringPool.intern(s);
+        static std::mutex lock;
+        std::lock_guard<std::mutex> guard(lock);
+        return global().StringPool.intern(s);
+    }
+
+    DataPool& DataPool::global() {
+        static DataPool pool(false);
+        return pool;
+    }
+
+    DataPool::DataPool(bool report)
+        : EntityPool(report), IntegerEntityPool(report), DomainPool(report), ConstraintPool(report), ObjectivePool(report), NodePool(report), groupData(new XGroupData()) {}
+
+    DataPool::~DataPool() {
+        delete groupData;
+    }
 
     void DataPool::clear() {
+        *groupData = XGroupData();
         EntityPool.clear();
         IntegerEntityPool.clear();
         DomainPool.clear();
         ConstraintPool.clear();
         ObjectivePool.clear();
         NodePool.clear();
+        StringPool.clear();
+    }
+
+    DataPool::Mark DataPool::mark() const {
+        Mark m = {EntityPool.mark(), IntegerEntityPool.mark(), DomainPool.mark(), ConstraintPool.mark(), ObjectivePool.mark(), NodePool.mark(), StringPool.mark()};
+        return m;
+    }
+
+    void DataPool::rewind(const Mark& m) {
+        // Constraints first: their destructors may use the other objects
+        ConstraintPool.rewind(m.constraints);
+        ObjectivePool.rewind(m.objectives);
+        NodePool.rewind(m.nodes);
+        DomainPool.rewind(m.domains);
+        IntegerEntityPool.rewind(m.integerEntities);
+        EntityPool.rewind(m.entities);
+        StringPool.rewind(m.strings);
+    }
+
+    void DataPool::reset() {
+        *groupData = XGroupData();
+        EntityPool.reset();
+        IntegerEntityPool.reset();
+        DomainPool.reset();
+        ConstraintPool.reset();
+        ObjectivePool.reset();
+        NodePool.reset();
+        StringPool.clear();
     }
 }
\ No newline at end of file
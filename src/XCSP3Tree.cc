@@ -69,7 +69,7 @@ static int min(T v1, T v2, T v3) {
 Node* Tree::fromStringToTree(std::string current) {
 
     current = trim(current);
-    std::vector<NodeOperator*> stack;
+    std::vector<Expr> stack;
     std::vector<Node*> params;
     while (true) {
         int posOpenParenthesis = current.find('(');
@@ -99,39 +99,29 @@ Node* Tree::fromStringToTree(std::string current) {
     return params.back();
 }
 
-extern NodeOperator* createNodeOperator(Expr e);
-void Tree::createOperator(std::string currentElement, std::vector<NodeOperator*>& stack, std::vector<Node*>& params) {
-
-    NodeOperator* tmp = createNodeOperator(stringToOperator(currentElement));
-    if (tmp == nullptr)
+void Tree::createOperator(std::string currentElement, std::vector<Expr>& stack, std::vector<Node*>& params) {
+    Expr op = stringToOperator(currentElement);
+    if (op == Expr::UNDEF)
         throw std::runtime_error("Intension constraint. Unknown operator: " + currentElement);
-    stack.push_back(tmp);
+    stack.push_back(op);
     params.push_back(nullptr); // delemitor
 }
 
-void Tree::closeOperator(std::vector<NodeOperator*>& stack, std::vector<Node*>& params) {
-    NodeOperator* tmp = stack.back();
-
+void Tree::closeOperator(std::vector<Expr>& stack, std::vector<Node*>& params) {
     int startParams = params.size() - 1;
     while (params[startParams] != nullptr)
         startParams--;
-    startParams++;
-    int nbP = 0;
-    for (unsigned int i = startParams; i < params.size(); i++, nbP++)
-        tmp->addParameter(params[i]);
+    std::vector<Node*> parameters(params.begin() + startParams + 1, params.end());
+    params.erase(params.begin() + startParams, params.end()); // with the delimitor
+    params.push_back(createNodeOperator(stack.back(), parameters));
     stack.pop_back();
-    //params.shrink(nbP);
-    params.erase(params.end() - nbP, params.end());
-    assert(params.back() == nullptr);
-    params.pop_back();
-    params.push_back(tmp);
 }
 
-// string currentElement, std::vector<NodeOperator*> &stack,std::vector<Node*> &params
-void Tree::createBasicParameter(std::string currentElement, std::vector<NodeOperator*>&, std::vector<Node*>& params) {
+// string currentElement, std::vector<Expr> &stack,std::vector<Node*> &params
+void Tree::createBasicParameter(std::string currentElement, std::vector<Expr>&, std::vector<Node*>& params) {
     try {
         int nb = std::stoi(currentElement);
-        params.push_back(DataPool::NodePool.make<NodeConstant>(nb));
+        params.push_back(createNodeConstant(nb));
     } catch (std::invalid_argument const&) {
         int position = -1;
         for (unsigned int i = 0; i < listOfVariables.size(); i++)
@@ -143,6 +133,12 @@ void Tree::createBasicParameter(std::string currentElement, std::vector<NodeOper
             listOfVariables.push_back(currentElement);
             position = listOfVariables.size() - 1;
         }
-        params.push_back(DataPool::NodePool.make<NodeVariable>(currentElement));
+        XVariable* x = nullptr;
+        if (symbols != nullptr) {
+            auto it = symbols->find(currentElement);
+            if (it != symbols->end() && it->second->isVariable())
+                x = static_cast<XVariable*>(it->second);
+        }
+        params.push_back(createNodeVariable(currentElement, x));
     }
 }
@@ -28,6 +28,7 @@
 #include "XCSP3Tree.h"
 #include "XCSP3TreeNode.h"
 #include "XCSP3Pool.h"
+#include "XCSP3Variable.h"
 #include <algorithm>
 #include <limits>
 #include <sstream>
@@ -130,49 +131,123 @@ Expr XCSP3Core::stringToOperator(const std::string& op) {
     return Expr::UNDEF;
 }
 
-NodeOperator* createNodeOperator(Expr op) {
+NodeOperator* XCSP3Core::createNodeOperator(Expr op) {
     NodeOperator* tmp = nullptr;
-    if (op == Expr::NEG) tmp = DataPool::NodePool.make<NodeNeg>();
-    if (op == Expr::ABS) tmp = DataPool::NodePool.make<NodeAbs>();
-
-    if (op == Expr::ADD) tmp = DataPool::NodePool.make<NodeAdd>();
-    if (op == Expr::SUB) tmp = DataPool::NodePool.make<NodeSub>();
-    if (op == Expr::MUL) tmp = DataPool::NodePool.make<NodeMult>();
-    if (op == Expr::DIV) tmp = DataPool::NodePool.make<NodeDiv>();
-    if (op == Expr::MOD) tmp = DataPool::NodePool.make<NodeMod>();
-
-    if (op == Expr::SQR) tmp = DataPool::NodePool.make<NodeSquare>();
-    if (op == Expr::POW) tmp = DataPool::NodePool.make<NodePow>();
-
-    if (op == Expr::MIN) tmp = DataPool::NodePool.make<NodeMin>();
-    if (op == Expr::MAX) tmp = DataPool::NodePool.make<NodeMax>();
-    if (op == Expr::DIST) tmp = DataPool::NodePool.make<NodeDist>();
-
-    if (op == Expr::LE) tmp = DataPool::NodePool.make<NodeLE>();
-    if (op == Expr::LT) tmp = DataPool::NodePool.make<NodeLT>();
-    if (op == Expr::GE) tmp = DataPool::NodePool.make<NodeGE>();
-    if (op == Expr::GT) tmp = DataPool::NodePool.make<NodeGT>();
-
-    if (op == Expr::NE) tmp = DataPool::NodePool.make<NodeNE>();
-    if (op == Expr::EQ) tmp = DataPool::NodePool.make<NodeEQ>();
-
-    if (op == Expr::NOT) tmp = DataPool::NodePool.make<NodeNot>();
-    if (op == Expr::AND) tmp = DataPool::NodePool.make<NodeAnd>();
-    if (op == Expr::OR) tmp = DataPool::NodePool.make<NodeOr>();
-    if (op == Expr::XOR) tmp = DataPool::NodePool.make<NodeXor>();
-    if (op == Expr::IMP) tmp = DataPool::NodePool.make<NodeImp>();
-    if (op == Expr::IF) tmp = DataPool::NodePool.make<NodeIf>();
-    if (op == Expr::IFF) tmp = DataPool::NodePool.make<NodeIff>();
-
-    if (op == Expr::IN) tmp = DataPool::NodePool.make<NodeIn>();
-    if (op == Expr::NOTIN) tmp = DataPool::NodePool.make<NodeNotIn>();
-    if (op == Expr::SET) tmp = DataPool::NodePool.make<NodeSet>();
+    if (op == Expr::NEG) tmp = DataPool::current().NodePool.make<NodeNeg>();
+    if (op == Expr::ABS) tmp = DataPool::current().NodePool.make<NodeAbs>();
+
+    if (op == Expr::ADD) tmp = DataPool::current().NodePool.make<NodeAdd>();
+    if (op == Expr::SUB) tmp = DataPool::current().NodePool.make<NodeSub>();
+    if (op == Expr::MUL) tmp = DataPool::current().NodePool.make<NodeMult>();
+    if (op == Expr::DIV) tmp = DataPool::current().NodePool.make<NodeDiv>();
+    if (op == Expr::MOD) tmp = DataPool::current().NodePool.make<NodeMod>();
+
+    if (op == Expr::SQR) tmp = DataPool::current().NodePool.make<NodeSquare>();
+    if (op == Expr::POW) tmp = DataPool::current().NodePool.make<NodePow>();
+
+    if (op == Expr::MIN) tmp = DataPool::current().NodePool.make<NodeMin>();
+    if (op == Expr::MAX) tmp = DataPool::current().NodePool.make<NodeMax>();
+    if (op == Expr::DIST) tmp = DataPool::current().NodePool.make<NodeDist>();
+
+    if (op == Expr::LE) tmp = DataPool::current().NodePool.make<NodeLE>();
+    if (op == Expr::LT) tmp = DataPool::current().NodePool.make<NodeLT>();
+    if (op == Expr::GE) tmp = DataPool::current().NodePool.make<NodeGE>();
+    if (op == Expr::GT) tmp = DataPool::current().NodePool.make<NodeGT>();
+
+    if (op == Expr::NE) tmp = DataPool::current().NodePool.make<NodeNE>();
+    if (op == Expr::EQ) tmp = DataPool::current().NodePool.make<NodeEQ>();
+
+    if (op == Expr::NOT) tmp = DataPool::current().NodePool.make<NodeNot>();
+    if (op == Expr::AND) tmp = DataPool::current().NodePool.make<NodeAnd>();
+    if (op == Expr::OR) tmp = DataPool::current().NodePool.make<NodeOr>();
+    if (op == Expr::XOR) tmp = DataPool::current().NodePool.make<NodeXor>();
+    if (op == Expr::IMP) tmp = DataPool::current().NodePool.make<NodeImp>();
+    if (op == Expr::IF) tmp = DataPool::current().NodePool.make<NodeIf>();
+    if (op == Expr::IFF) tmp = DataPool::current().NodePool.make<NodeIff>();
+
+    if (op == Expr::IN) tmp = DataPool::current().NodePool.make<NodeIn>();
+    if (op == Expr::NOTIN) tmp = DataPool::current().NodePool.make<NodeNotIn>();
+    if (op == Expr::SET) tmp = DataPool::current().NodePool.make<NodeSet>();
 
     assert(tmp != nullptr);
 
     return tmp;
 }
 
+NodeVariable::NodeVariable(std::string v, XVariable* x) : Node(Expr::VAR), var(v), variable(x), index(x == nullptr ? -1 : x->index) {}
+
+//-------------------------------------
+// Hash-consing
+//-------------------------------------
+
+thread_local NodeFactory* NodeFactory::current = nullptr;
+
+static size_t combine(size_t h, size_t v) {
+    return h ^ (v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2));
+}
+
+Node* NodeFactory::find(size_t h, Expr type, int val, const std::string* var, XVariable* x, std::vector<Node*>* params) {
+    auto range = nodes.equal_range(h);
+    for (auto it = range.first; it != range.second; ++it) {
+        Node* n = it->second;
+        if (n->type != type)
+            continue;
+        // A variable is shared only with the same binding: a name created unbound (template, pattern) is another node
+        if (type == Expr::DECIMAL ? static_cast<NodeConstant*>(n)->val == val
+                                  : type == Expr::VAR ? static_cast<NodeVariable*>(n)->var == *var && static_cast<NodeVariable*>(n)->variable == x
+                                                      : n->parameters == *params) {
+            shared++;
+            return n;
+        }
+    }
+    return nullptr;
+}
+
+Node* NodeFactory::insert(size_t h, Node* node) {
+    node->hash = h;
+    nodes.insert(std::make_pair(h, node));
+    created++;
+    return node;
+}
+
+Node* NodeFactory::constant(int val) {
+    size_t h = combine(static_cast<size_t>(Expr::DECIMAL), std::hash<int>()(val));
+    Node* n = find(h, Expr::DECIMAL, val, nullptr, nullptr, nullptr);
+    return n != nullptr ? n : insert(h, DataPool::current().NodePool.make<NodeConstant>(val));
+}
+
+Node* NodeFactory::variable(const std::string& var, XVariable* x) {
+    size_t h = combine(combine(static_cast<size_t>(Expr::VAR), std::hash<std::string>()(var)), std::hash<XVariable*>()(x));
+    Node* n = find(h, Expr::VAR, 0, &var, x, nullptr);
+    return n != nullptr ? n : insert(h, DataPool::current().NodePool.make<NodeVariable>(var, x));
+}
+
+Node* NodeFactory::node(Expr type, std::vector<Node*>& params) {
+    size_t h = static_cast<size_t>(type);
+    for (Node* p : params) // parameters are shared: equal iff same pointers
+        h = combine(h, p->hash);
+    Node* n = find(h, type, 0, nullptr, nullptr, &params);
+    return n != nullptr ? n : insert(h, createNodeOperator(type)->addParameters(params));
+}
+
+Node* XCSP3Core::createNodeConstant(int val) {
+    if (NodeFactory::current != nullptr)
+        return NodeFactory::current->constant(val);
+    return DataPool::current().NodePool.make<NodeConstant>(val);
+}
+
+Node* XCSP3Core::createNodeVariable(const std::string& var, XVariable* x) {
+    if (NodeFactory::current != nullptr)
+        return NodeFactory::current->variable(var, x);
+    return DataPool::current().NodePool.make<NodeVariable>(var, x);
+}
+
+Node* XCSP3Core::createNodeOperator(Expr type, std::vector<Node*>& params) {
+    if (NodeFactory::current != nullptr)
+        return NodeFactory::current->node(type, params);
+    return createNodeOperator(type)->addParameters(params);
+}
+
 Expr XCSP3Core::logicalInversion(Expr type) {
     switch (type) {
     case Expr::LT:
@@ -206,6 +281,8 @@ Expr XCSP3Core::logicalInversion(Expr type) {
 }
 
 int equalNodes(Node* a, Node* b) { // return -1 if a<0, 0 if a=b, +1 si a>b
+    if (a == b) // always the case for equal shared nodes
+        return 0;
     if (a->type != b->type)
         return static_cast<int>(a->type) - static_cast<int>(b->type);
 
@@ -235,11 +312,24 @@ bool compareNodes(Node* a, Node* b) {
     return equalNodes(a, b) < 0;
 }
 
+// The variable node with this name: it is reused in order to keep the related XVariable
+static Node* findVariable(Node* node, const std::string& name) {
+    if (node->type == Expr::VAR && static_cast<NodeVariable*>(node)->var == name)
+        return node;
+    for (Node* n : node->parameters) {
+        Node* v = findVariable(n, name);
+        if (v != nullptr)
+            return v;
+    }
+    return nullptr;
+}
+
 bool pattern(Node* node, std::string s,
              std::vector<Expr>& operators, std::vector<int>& constants, std::vector<std::string>& variables, bool fakeR = false) {
     constants.clear();
     variables.clear();
     operators.clear();
+    NodeFactory::Suspend suspend; // the root can be modified
     Tree pattern(s);
     if (fakeR)
         pattern.root->type = Expr::FAKEOP;
@@ -273,20 +363,19 @@ Node* NodeOperator::canonize() {
     }
 
     // Now, some specific reformulation rules are applied
+    // Nodes are never modified: they can be shared
     if (newType == Expr::LT && newParams[1]->type == Expr::DECIMAL) { // lt(x,k) becomes le(x,k-1)
         NodeConstant* c = dynamic_cast<NodeConstant*>(newParams[1]);
-        c->val = c->val - 1;
-        return DataPool::NodePool.make<NodeLE>()->addParameter(newParams[0])->addParameter(newParams[1])->canonize();
+        return DataPool::current().NodePool.make<NodeLE>()->addParameter(newParams[0])->addParameter(createNodeConstant(c->val - 1))->canonize();
     }
     if (newType == Expr::LT && newParams[0]->type == Expr::DECIMAL) { // lt(k,x) becomes le(k+1,x)
         NodeConstant* c = dynamic_cast<NodeConstant*>(newParams[0]);
-        c->val = c->val + 1;
-        return DataPool::NodePool.make<NodeLE>()->addParameter(newParams[0])->addParameter(newParams[1])->canonize();
+        return DataPool::current().NodePool.make<NodeLE>()->addParameter(createNodeConstant(c->val + 1))->addParameter(newParams[1])->canonize();
     }
 
     NodeOperator* tmp = dynamic_cast<NodeOperator*>(newParams[0]); // abs(sub becomes dist
     if (newType == Expr::ABS && newParams[0]->type == Expr::SUB)
-        return DataPool::NodePool.make<NodeDist>()->addParameters(tmp->parameters)->canonize();
+        return DataPool::current().NodePool.make<NodeDist>()->addParameters(tmp->parameters)->canonize();
 
     if (newType == Expr::NOT && newParams[0]->type == Expr::NOT) // NOT(NOT.. becomes ..
         return tmp->parameters[0]->canonize();
@@ -307,12 +396,12 @@ Node* NodeOperator::canonize() {
             (c2 = dynamic_cast<NodeConstant*>(newParams[newParams.size() - 2])) != nullptr) {
             std::vector<Node*> l;
             l.insert(l.end(), newParams.begin(), newParams.end() - 2);
-            l.push_back(newType == Expr::ADD ? DataPool::NodePool.make<NodeConstant>(c1->val + c2->val) : DataPool::NodePool.make<NodeConstant>(c1->val * c2->val));
+            l.push_back(newType == Expr::ADD ? createNodeConstant(c1->val + c2->val) : createNodeConstant(c1->val * c2->val));
 
             if (newType == Expr::ADD)
-                return DataPool::NodePool.make<NodeAdd>()->addParameters(l)->canonize();
+                return DataPool::current().NodePool.make<NodeAdd>()->addParameters(l)->canonize();
             else
-                return DataPool::NodePool.make<NodeMult>()->addParameters(l)->canonize();
+                return DataPool::current().NodePool.make<NodeMult>()->addParameters(l)->canonize();
         }
     }
 
@@ -320,8 +409,8 @@ Node* NodeOperator::canonize() {
     if (pattern(this, "le(add(y[4],5),7)", operators, constants, variables, true)) {
         if (newType == Expr::EQ || newType == Expr::NE || newType == Expr::LE || newType == Expr::LT)
             return createNodeOperator(newType)
-                ->addParameter(DataPool::NodePool.make<NodeVariable>(variables[0]))
-                ->addParameter(DataPool::NodePool.make<NodeConstant>(constants[1] - constants[0]))
+                ->addParameter(findVariable(this, variables[0]))
+                ->addParameter(createNodeConstant(constants[1] - constants[0]))
                 ->canonize();
     }
 
@@ -329,8 +418,8 @@ Node* NodeOperator::canonize() {
     if (pattern(this, "le(8,add(y[4],5))", operators, constants, variables, true)) {
         if (newType == Expr::EQ || newType == Expr::NE || newType == Expr::LE || newType == Expr::LT)
             return createNodeOperator(newType)
-                ->addParameter(DataPool::NodePool.make<NodeConstant>(constants[0] - constants[1]))
-                ->addParameter(DataPool::NodePool.make<NodeVariable>(variables[0]))
+                ->addParameter(createNodeConstant(constants[0] - constants[1]))
+                ->addParameter(findVariable(this, variables[0]))
                 ->canonize();
     }
 
@@ -338,8 +427,8 @@ Node* NodeOperator::canonize() {
     if (pattern(this, "le(8,add(5,y[4]))", operators, constants, variables, true)) {
         if (newType == Expr::EQ || newType == Expr::NE || newType == Expr::LE || newType == Expr::LT)
             return createNodeOperator(newType)
-                ->addParameter(DataPool::NodePool.make<NodeConstant>(constants[0] - constants[1]))
-                ->addParameter(DataPool::NodePool.make<NodeVariable>(variables[0]))
+                ->addParameter(createNodeConstant(constants[0] - constants[1]))
+                ->addParameter(findVariable(this, variables[0]))
                 ->canonize();
     }
 
@@ -347,16 +436,16 @@ Node* NodeOperator::canonize() {
     if (pattern(this, "eq(mul(y[0],3),9)", operators, constants, variables) ||
         pattern(this, "eq(mul(3,x),6)", operators, constants, variables)) {
         if (constants[1] % constants[0] != 0)
-            return DataPool::NodePool.make<NodeConstant>(0);
-        return DataPool::NodePool.make<NodeEQ>()->addParameter(DataPool::NodePool.make<NodeVariable>(variables[0]))->addParameter(DataPool::NodePool.make<NodeConstant>(constants[1] / constants[0]))->canonize();
+            return createNodeConstant(0);
+        return DataPool::current().NodePool.make<NodeEQ>()->addParameter(findVariable(this, variables[0]))->addParameter(createNodeConstant(constants[1] / constants[0]))->canonize();
     }
 
     //eq(9,mul(3,y[0]))
     if (pattern(this, "eq(9,mul(3,y[0]))", operators, constants, variables) ||
         pattern(this, "eq(9,mul(y[0],3))", operators, constants, variables)) {
         if (constants[0] % constants[1] != 0)
-            return DataPool::NodePool.make<NodeConstant>(0);
-        return DataPool::NodePool.make<NodeEQ>()->addParameter(DataPool::NodePool.make<NodeVariable>(variables[0]))->addParameter(DataPool::NodePool.make<NodeConstant>(constants[0] / constants[1]))->canonize();
+            return createNodeConstant(0);
+        return DataPool::current().NodePool.make<NodeEQ>()->addParameter(findVariable(this, variables[0]))->addParameter(createNodeConstant(constants[0] / constants[1]))->canonize();
     }
 
     // Then, we merge operators when possible; for example add(add(x,y),z) becomes add(x,y,z)
@@ -381,16 +470,16 @@ Node* NodeOperator::canonize() {
         NodeOperator* n1 = dynamic_cast<NodeOperator*>(newParams[1]);
         // First, we replace sub by add when possible
         if (newParams[0]->type == Expr::SUB && newParams[1]->type == Expr::SUB) {
-            Node* a = DataPool::NodePool.make<NodeAdd>()->addParameter(n0->parameters[0])->addParameter(n1->parameters[1]);
-            Node* b = DataPool::NodePool.make<NodeAdd>()->addParameter(n1->parameters[0])->addParameter(n0->parameters[1]);
+            Node* a = DataPool::current().NodePool.make<NodeAdd>()->addParameter(n0->parameters[0])->addParameter(n1->parameters[1]);
+            Node* b = DataPool::current().NodePool.make<NodeAdd>()->addParameter(n1->parameters[0])->addParameter(n0->parameters[1]);
             return (createNodeOperator(newType))->addParameter(a)->addParameter(b)->canonize();
         } else if (newParams[1]->type == Expr::SUB) {
-            Node* a = DataPool::NodePool.make<NodeAdd>()->addParameter(newParams[0])->addParameter(n1->parameters[1]);
+            Node* a = DataPool::current().NodePool.make<NodeAdd>()->addParameter(newParams[0])->addParameter(n1->parameters[1]);
             Node* b = n1->parameters[0];
             return (createNodeOperator(newType))->addParameter(a)->addParameter(b)->canonize();
         } else if (n0 != nullptr && n0->op == "sub") {
             Node* a = n0->parameters[0];
-            Node* b = DataPool::NodePool.make<NodeAdd>()->addParameter(newParams[1])->addParameter(n0->parameters[1]);
+            Node* b = DataPool::current().NodePool.make<NodeAdd>()->addParameter(newParams[1])->addParameter(n0->parameters[1]);
             return (createNodeOperator(newType))->addParameter(a)->addParameter(b)->canonize();
         }
 
@@ -399,7 +488,7 @@ Node* NodeOperator::canonize() {
             if (n0->parameters.size() == 2 && n0->parameters[0]->type == Expr::VAR && n0->parameters[1]->type == Expr::DECIMAL) {
                 NodeConstant* c1 = dynamic_cast<NodeConstant*>(newParams[1]);
                 NodeConstant* c2 = dynamic_cast<NodeConstant*>(n0->parameters[1]);
-                return (createNodeOperator(newType))->addParameter(n0->parameters[0])->addParameter(DataPool::NodePool.make<NodeConstant>(c1->val - c2->val))->canonize();
+                return (createNodeOperator(newType))->addParameter(n0->parameters[0])->addParameter(createNodeConstant(c1->val - c2->val))->canonize();
             }
         }
 
@@ -408,14 +497,14 @@ Node* NodeOperator::canonize() {
             if (n0->parameters.size() == 2 && n1->parameters.size() == 2 &&
                 (c1 = dynamic_cast<NodeConstant*>(n0->parameters[1])) != nullptr &&
                 (c2 = dynamic_cast<NodeConstant*>(n1->parameters[1])) != nullptr) {
-                c1->val = c1->val - c2->val;
+                newParams[0] = DataPool::current().NodePool.make<NodeAdd>()->addParameter(n0->parameters[0])->addParameter(createNodeConstant(c1->val - c2->val));
                 newParams[1] = n1->parameters[0];
                 return (createNodeOperator(newType))->addParameters(newParams)->canonize();
             }
         }
     }
 
-    return (createNodeOperator(newType))->addParameters(newParams);
+    return createNodeOperator(newType, newParams);
 }
 
 // -----------------------------------------
@@ -27,6 +27,7 @@
 #include "XCSP3Constraint.h"
 #include "XCSP3Domain.h"
 #include "XCSP3Variable.h"
+#include <algorithm>
 
 using namespace XCSP3Core;
 
@@ -35,6 +36,11 @@ using namespace XCSP3Core;
 //------------------------------------------------------------------------------------------
 
 void XMLParser::startElement(UTF8String name, const AttributeList& attributes) {
+    if (skipDepth > 0) {
+        skipDepth++;
+        return;
+    }
+
     // consume the last tokens before we switch to the next element
     if (!textLeft.empty()) {
         handleAbridgedNotation(textLeft, true);
@@ -59,12 +65,24 @@ void XMLParser::startElement(UTF8String name, const AttributeList& attributes) {
         std::cerr << "unknown tag " << name << std::endl;
     }
 
+    if (discardedSubtree(name, attributes)) {
+        skipDepth = 1;
+        return;
+    }
+
     stateStack.push_front(State());
     actionStack.push_front(action);
+    if (releasableConstraint())
+        manager->beginConstraintStorage();
     action->beginTag(attributes);
 }
 
 void XMLParser::endElement(UTF8String name) {
+    if (skipDepth > 0) {
+        skipDepth--;
+        return;
+    }
+
     // consume the last tokens
     if (!textLeft.empty()) {
         handleAbridgedNotation(textLeft, true);
@@ -72,16 +90,60 @@ void XMLParser::endElement(UTF8String name) {
     }
 
     TagActionList::iterator iAction = tagList.find(name);
+    bool release = releasableConstraint();
 
     if (iAction != tagList.end())
         (*iAction).second->endTag();
+    if (release)
+        manager->endConstraintStorage();
 
     actionStack.pop_front();
     stateStack.pop_front();
 }
 
+bool XMLParser::postSlice(ConstraintType type, XConstraint* constraint, bool alone) {
+    sliceAllowed = false;
+    if (slice.array == nullptr)
+        return false;
+    bool handled = alone && manager->newConstraintSlice(type, constraint, slice);
+    if (handled == false)
+        slice.getVars(lists[0]);
+    slice.array = nullptr;
+    return handled;
+}
+
+bool XMLParser::discardedSubtree(const UTF8String& name, const AttributeList& attributes) {
+    if (name == UTF8String("annotations"))
+        return manager->callback->skipAnnotations;
+    if (name == UTF8String("objectives"))
+        return manager->callback->skipObjectives;
+
+    // Only constraints, blocks, groups and slides are skipped from their classes (variables are always declared)
+    if (manager->discarding() == false || actionStack.empty())
+        return false;
+    const std::string& parent = actionStack.front()->tagName;
+    if (parent != "constraints" && parent != "block")
+        return false;
+    UTF8String classes = attributes["class"];
+    if (classes.isNull())
+        return false;
+    std::string tmp;
+    classes.to(tmp);
+    return manager->classesDiscarded(tmp);
+}
+
+bool XMLParser::releasableConstraint() {
+    if (manager->callback->releaseConstraints == false || actionStack.size() < 2)
+        return false;
+    const std::string& tag = actionStack[0]->tagName;
+    const std::string& parent = actionStack[1]->tagName;
+    return tag != "block" && (parent == "constraints" || parent == "block");
+}
+
 void XMLParser::characters(UTF8String chars) {
     //cout << "chars=" << chars << "#" << endl;
+    if (skipDepth > 0)
+        return;
 
     if (actionStack.empty()) {
         if (chars.isWhiteSpace())
@@ -169,83 +231,147 @@ void XMLParser::handleAbridgedNotation(UTF8String chars, bool lastChunk) {
 //    or a basic entity, or a template parameter
 //------------------------------------------------------------------------------------------
 
+// The kinds of tokens of a sequence
+enum class SequenceToken { INTEGER, RANGE, COMPACT_FORM, PARAMETER, TREE, IDENTIFIER };
+
+// Read the integer [+-]digits in [b, e), return false if it is not one
+static bool readInteger(const char* b, const char* e, int& value) {
+    const UTF8String::Byte* begin = reinterpret_cast<const UTF8String::Byte*>(b);
+    const UTF8String::Byte* end = reinterpret_cast<const UTF8String::Byte*>(e);
+    const UTF8String::Byte* p = UTF8String::parseInteger(begin, end, value);
+    return p != begin && p == end;
+}
+
+// Read a token which is an integer (interval is false) or an interval first..last, return false if it is neither
+static bool readIntegerOrInterval(const UTF8String& token, int& first, int& last, bool& interval) {
+    const UTF8String::Byte *b = token.begin().getPointer(), *e = token.end().getPointer();
+    const UTF8String::Byte* p = UTF8String::parseInteger(b, e, first);
+    if (p == b)
+        return false;
+    interval = e - p >= 2 && p[0] == '.' && p[1] == '.';
+    if (interval) {
+        b = p + 2;
+        p = UTF8String::parseInteger(b, e, last);
+        if (p == b)
+            return false;
+    }
+    return p == e;
+}
+
+// Classify a token in one pass over its bytes: tree (a parenthesis), parameter (%i or %...), compact form (a bracket, at is its position),
+// range (first..last), integer or identifier
+static SequenceToken classifyToken(const char* b, const char* e, const char*& at, int& first, int& last) {
+    const char *bracket = nullptr, *dot = nullptr;
+    bool percent = false;
+    for (const char* p = b; p != e; p++) {
+        switch (*p) {
+            case '(':
+                return SequenceToken::TREE;
+            case '%':
+                percent = true;
+                break;
+            case '[':
+                if (bracket == nullptr)
+                    bracket = p;
+                break;
+            case '.':
+                if (dot == nullptr)
+                    dot = p;
+                break;
+            default:
+                break;
+        }
+    }
+    if (percent)
+        return SequenceToken::PARAMETER;
+    if (bracket != nullptr) {
+        at = bracket;
+        return SequenceToken::COMPACT_FORM;
+    }
+    if (dot != nullptr) {
+        if (e - dot < 2 || dot[1] != '.' || readInteger(b, dot, first) == false || readInteger(dot + 2, e, last) == false)
+            throw std::runtime_error("bad range: " + std::string(b, e));
+        return SequenceToken::RANGE;
+    }
+    return readInteger(b, e, first) ? SequenceToken::INTEGER : SequenceToken::IDENTIFIER;
+}
+
 void XMLParser::parseSequence(const UTF8String& txt, std::vector<XVariable*>& list, std::vector<char> delimiters) {
     UTF8String::Tokenizer tokenizer(txt);
 
     for (char c : delimiters)
         tokenizer.addSeparator(c);
 
+    std::string name; // reused by the tokens
     while (tokenizer.hasMoreTokens()) {
 
         UTF8String token = tokenizer.nextToken();
-        bool isSep = false;
-        for (unsigned int i = 0; i < delimiters.size(); i++) {
-            std::string tt;
-            token.to(tt);
-            if (tt.size() == 1 && tt[0] == delimiters[i]) {
-                if (i == 0)
+        if (slice.array != nullptr && &list == &lists[0]) { // the list is not only the slice
+            slice.getVars(list);
+            slice.array = nullptr;
+        }
+        const char* b = reinterpret_cast<const char*>(token.begin().getPointer());
+        const char* e = reinterpret_cast<const char*>(token.end().getPointer());
+        if (e - b == 1) {
+            std::vector<char>::iterator sep = std::find(delimiters.begin(), delimiters.end(), *b);
+            if (sep != delimiters.end()) {
+                if (sep == delimiters.begin())
                     list.push_back(NULL);
-                isSep = true;
+                continue;
             }
         }
-        if (isSep)
-            continue;
 
-        std::string current, compactForm;
-        token.to(current);
-        current = trim(current);
-        size_t tree = current.find('(');
-        if (tree != std::string::npos) { // Tree expressions
-            list.push_back(new XTree(current));
-            continue;
-        }
-        size_t percent = current.find('%');
-        if (percent == std::string::npos) { // Normal variable
-            size_t pos = current.find('[');
-            if (pos == std::string::npos) { // Not an array
-                size_t dotdot = current.find('.');
-                if (dotdot == std::string::npos) {
-                    int nb;
-                    try { // An integer
-                        nb = std::stoi(current);
-                        XInteger* xi = DataPool::EntityPool.make<XInteger>(current, nb);
+        const char* bracket = nullptr;
+        int first = 0, last = 0;
+        switch (classifyToken(b, e, bracket, first, last)) {
+            case SequenceToken::TREE: // Tree expressions
+                list.push_back(new XTree(std::string(b, e)));
+                break;
+            case SequenceToken::PARAMETER: { // Parameter Variable form group template
+                XParameterVariable* xpv = DataPool::current().EntityPool.make<XParameterVariable>(std::string(b, e));
+                if (xpv->number == -1)
+                    nbParameters = -1;
+                else
+                    nbParameters++;
+                if (maxParameter < xpv->number)
+                    maxParameter = xpv->number;
+                list.push_back(xpv);
+                break;
+            }
+            case SequenceToken::INTEGER:
+                list.push_back(DataPool::current().EntityPool.make<XInteger>(std::string(b, e), first));
+                break;
+            case SequenceToken::RANGE:
+                if (keepIntervals) {
+                    list.push_back(DataPool::current().EntityPool.make<XEInterval>(std::string(b, e), first, last));
+                } else {
+                    for (int i = first; i <= last; i++) {
+                        XInteger* xi = DataPool::current().EntityPool.make<XInteger>(std::to_string(i), i);
                         list.push_back(xi);
-
-                    } catch (std::invalid_argument& e) {
-                        if (variablesList[current] != NULL)
-                            list.push_back(static_cast<XVariable*>(variablesList[current]));
-                        else
-                            throw std::runtime_error("unknown variable: " + current);
-                    }
-                } else { // A range
-                    int first = std::stoi(current.substr(0, dotdot));
-                    int last = std::stoi(current.substr(dotdot + 2));
-                    if (keepIntervals) {
-                        list.push_back(DataPool::EntityPool.make<XEInterval>(current, first, last));
-                    } else {
-                        for (int i = first; i <= last; i++) {
-                            XInteger* xi = DataPool::EntityPool.make<XInteger>(std::to_string(i), i);
-                            list.push_back(xi);
-                        }
                     }
                 }
-            } else {
-                std::string name;
-                token.substr(0, pos).to(name);
-                token.substr(pos).to(compactForm);
-
-                if (variablesList[name] == NULL)
+                break;
+            case SequenceToken::IDENTIFIER: { // Normal variable
+                name.assign(b, e);
+                std::map<std::string, XEntity*>::iterator entity = variablesList.find(name);
+                if (entity == variablesList.end() || entity->second == NULL)
                     throw std::runtime_error("unknown variable: " + name);
-                (static_cast<XVariableArray*>(variablesList[name]))->getVarsFor(list, compactForm);
+                list.push_back(static_cast<XVariable*>(entity->second));
+                break;
+            }
+            case SequenceToken::COMPACT_FORM: {
+                name.assign(b, bracket);
+                std::map<std::string, XEntity*>::iterator entity = variablesList.find(name);
+                if (entity == variablesList.end() || entity->second == NULL)
+                    throw std::runtime_error("unknown variable: " + name);
+                XVariableArray* array = static_cast<XVariableArray*>(entity->second);
+                name.assign(bracket, e);
+                if (sliceAllowed && list.empty() && &list == &lists[0])
+                    array->sliceFor(name, slice); // expanded later if needed
+                else
+                    array->getVarsFor(list, name);
+                break;
             }
-        } else {
-            // Parameter Variable form group template
-            XParameterVariable* xpv = DataPool::EntityPool.make<XParameterVariable>(current);
-            if (xpv->number == -1)
-                nbParameters = -1;
-            else
-                nbParameters++;
-            list.push_back(xpv);
         }
     }
 }
@@ -259,22 +385,26 @@ bool XMLParser::parseTuples(const UTF8String& txt, std::vector<std::vector<int>>
     tokenizer.addSeparator('(');
     while (tokenizer.hasMoreTokens()) {
         UTF8String token = tokenizer.nextToken();
-        if (token == UTF8String(","))
+        const UTF8String::Byte *b = token.begin().getPointer(), *e = token.end().getPointer();
+        if (e - b == 1 && *b == ',')
             continue;
-        if (token == UTF8String("(")) {
+        if (e - b == 1 && *b == '(') {
             currentTuple.clear();
             continue;
         }
-        if (token == UTF8String(")")) {
+        if (e - b == 1 && *b == ')') {
             tuples.push_back(std::vector<int>(currentTuple.begin(), currentTuple.end()));
             continue;
         }
         int val = -1;
-        if (token == UTF8String("*")) {
+        if (e - b == 1 && *b == '*') {
             hasStar = true;
             val = STAR;
-        } else
-            token.to(val);
+        } else if (UTF8String::parseInteger(b, e, val) != e || b == e) {
+            std::string ts;
+            token.to(ts);
+            throw std::runtime_error("Integer expected in tuple: " + ts);
+        }
         currentTuple.push_back(val);
     }
     return hasStar;
@@ -282,57 +412,37 @@ bool XMLParser::parseTuples(const UTF8String& txt, std::vector<std::vector<int>>
 
 void XMLParser::parseDomain(const UTF8String& txt, XDomainInteger& domain) {
     UTF8String::Tokenizer tokenizer(txt);
-    UTF8String dotdot("..");
     while (tokenizer.hasMoreTokens()) {
         UTF8String token = tokenizer.nextToken();
-        size_t pos = token.find(dotdot);
-
-        if (pos == UTF8String::npos) {
-            int val;
-            if (false == token.to(val)) {
-                std::string ds;
-                txt.to(ds);
-                throw std::runtime_error("Integer expected: " + ds);
-            }
-            domain.addValue(val);
-        } else {
-            int first, last;
-            if ((false == token.substr(0, pos).to(first)) || (false == token.substr(pos + 2).to(last))) {
-                std::string ds;
-                txt.to(ds);
-                throw std::runtime_error("Integer expected: " + ds);
-            }
-            domain.addInterval(first, last);
+        int first, last;
+        bool interval;
+        if (readIntegerOrInterval(token, first, last, interval) == false) {
+            std::string ds;
+            txt.to(ds);
+            throw std::runtime_error("Integer expected: " + ds);
         }
+        if (interval)
+            domain.addInterval(first, last);
+        else
+            domain.addValue(first);
     }
 }
 
 void XMLParser::parseListOfIntegerOrInterval(const UTF8String& txt, std::vector<XIntegerEntity*>& listToFill) {
     UTF8String::Tokenizer tokenizer(txt);
-    UTF8String dotdot = "..";
     while (tokenizer.hasMoreTokens()) {
         UTF8String token = tokenizer.nextToken();
-        size_t pos = token.find(dotdot);
-
-        if (pos == UTF8String::npos) {
-            int val;
-            if (false == token.to(val)) {
-                std::string ds;
-                txt.to(ds);
-                throw std::runtime_error("Integer expected: " + ds);
-            }
-            XIntegerValue* xv = DataPool::IntegerEntityPool.make<XIntegerValue>(val);
-            listToFill.push_back(xv);
-        } else {
-            int first, last;
-            if ((false == token.substr(0, pos).to(first)) || (false == token.substr(pos + 2).to(last))) {
-                std::string ds;
-                txt.to(ds);
-                throw std::runtime_error("Integer expected: " + ds);
-            }
-            XIntegerInterval* xi = DataPool::IntegerEntityPool.make<XIntegerInterval>(first, last);
-            listToFill.push_back(xi);
+        int first, last;
+        bool interval;
+        if (readIntegerOrInterval(token, first, last, interval) == false) {
+            std::string ds;
+            txt.to(ds);
+            throw std::runtime_error("Integer expected: " + ds);
         }
+        if (interval)
+            listToFill.push_back(DataPool::current().IntegerEntityPool.make<XIntegerInterval>(first, last));
+        else
+            listToFill.push_back(DataPool::current().IntegerEntityPool.make<XIntegerValue>(first));
     }
 }
 
@@ -342,6 +452,10 @@ void XMLParser::parseListOfIntegerOrInterval(const UTF8String& txt, std::vector<
 
 XMLParser::XMLParser(XCSP3CoreCallbacksBase* cb) {
     keepIntervals = false;
+    sliceAllowed = false;
+    skipDepth = 0;
+    nbVariables = 0;
+    maxParameter = -1;
     this->manager.reset(new XCSP3Manager(cb, variablesList));
     unknownTagHandler.reset(new UnknownTagAction(this, "unknown"));
 
@@ -435,3 +549,39 @@ XMLParser::XMLParser(XCSP3CoreCallbacksBase* cb) {
 
 XMLParser::~XMLParser() {
 }
+
+void XMLParser::reset() {
+    variablesList.clear();
+    allDomains.clear();
+    constraints.clear();
+    nbVariables = 0;
+    maxParameter = -1;
+    keepIntervals = false;
+    sliceAllowed = false;
+    slice = XArraySlice();
+    skipDepth = 0;
+    manager->reset();
+
+    clearStacks();
+    actionStack.clear();
+    textLeft.clear();
+    lists.clear();
+    matrix.clear();
+    patterns.clear();
+    args.clear();
+    values.clear();
+    occurs.clear();
+    integers.clear();
+    origins.clear();
+    lengths.clear();
+    ends.clear();
+    heights.clear();
+    widths.clear();
+    currentTuple.clear();
+    classes.clear();
+    condition.clear();
+    expr.clear();
+    start.clear();
+    final.clear();
+    transitions.clear();
+}
@@ -75,8 +75,8 @@ void XMLParser::VarTagAction::beginTag(const AttributeList& attributes) {
 
     this->checkParentTag("variables");
     this->parser->stateStack.front().subtagAllowed = false;
-    if (variable != NULL)
-        variable = NULL;
+    variable = NULL;
+    variableArray = NULL;
 
     if (!attributes["id"].to(lid))
         throw std::runtime_error("expected attribute id for tag <var>");
@@ -98,14 +98,15 @@ void XMLParser::VarTagAction::beginTag(const AttributeList& attributes) {
         XVariableArray* similarArray;
         if (this->parser->variablesList[as] == NULL)
             throw std::runtime_error("Variable as \"" + as + "\" does not exist");
-        if ((similarArray = dynamic_cast<XVariableArray*>(this->parser->variablesList[as])) != NULL) {
-            variableArray = DataPool::EntityPool.make<XVariableArray>(id, similarArray);
+        if (this->parser->variablesList[as]->kind == EntityKind::ARRAY) {
+            similarArray = static_cast<XVariableArray*>(this->parser->variablesList[as]);
+            variableArray = DataPool::current().EntityPool.make<XVariableArray>(id, similarArray);
         } else {
             XVariable* similar = static_cast<XVariable*>(this->parser->variablesList[as]);
-            variable = DataPool::EntityPool.make<XVariable>(id, similar->domain);
+            variable = DataPool::current().EntityPool.make<XVariable>(id, similar->domain);
         }
     } else {
-        domain = DataPool::DomainPool.make<XDomainInteger>();
+        domain = DataPool::current().DomainPool.make<XDomainInteger>();
         this->parser->allDomains.emplace_back(domain);
     }
 }
@@ -123,15 +124,15 @@ void XMLParser::VarTagAction::endTag() {
         this->parser->manager->beginVariableArray(variableArray->id);
         this->parser->variablesList[variableArray->id] = variableArray;
         for (XVariable* x : variableArray->variables)
-            this->parser->variablesList[x->id] = x;
+            this->parser->declareVariable(x);
         this->parser->manager->buildVariableArray(variableArray);
         this->parser->manager->endVariableArray();
         return;
     }
     if (variable == NULL)
-        variable = DataPool::EntityPool.make<XVariable>(id, domain);
+        variable = DataPool::current().EntityPool.make<XVariable>(id, domain);
     variable->classes = classes;
-    this->parser->variablesList[variable->id] = variable;
+    this->parser->declareVariable(variable);
     this->parser->manager->buildVariable(variable);
 }
 
@@ -167,7 +168,7 @@ void XMLParser::ArrayTagAction::beginTag(const AttributeList& attributes) {
         if (this->parser->variablesList[as] == nullptr)
             throw std::runtime_error("Matrix variable as \"" + as + "\" does not exist");
         XVariableArray* similar = static_cast<XVariableArray*>(this->parser->variablesList[as]);
-        varArray = DataPool::EntityPool.make<XVariableArray>(id, similar);
+        varArray = DataPool::current().EntityPool.make<XVariableArray>(id, similar);
     } else {
         if (!attributes["size"].to(size))
             throw std::runtime_error("expected attribute id for tag <array>");
@@ -177,9 +178,9 @@ void XMLParser::ArrayTagAction::beginTag(const AttributeList& attributes) {
                 continue;
             sizes.push_back(std::stoi(stringSizes[i].substr(0, stringSizes[i].size() - 1)));
         }
-        varArray = DataPool::EntityPool.make<XVariableArray>(id, sizes);
+        varArray = DataPool::current().EntityPool.make<XVariableArray>(id, sizes);
 
-        domain = DataPool::DomainPool.make<XDomainInteger>();
+        domain = DataPool::current().DomainPool.make<XDomainInteger>();
         this->parser->allDomains.push_back(domain);
         this->parser->manager->beginVariableArray(id);
     }
@@ -190,11 +191,11 @@ void XMLParser::ArrayTagAction::beginTag(const AttributeList& attributes) {
 void XMLParser::ArrayTagAction::endTag() {
     if (domain != nullptr && domain->nbValues() != 0) // If dommain is null -> as variable // Possible empty variables
         varArray->buildVarsWith(domain);
-    this->parser->variablesList[varArray->id] = DataPool::EntityPool.make<XVariableArray>(*varArray);
+    this->parser->variablesList[varArray->id] = DataPool::current().EntityPool.make<XVariableArray>(*varArray);
     for (XVariable* x : varArray->variables) {
         if (x == nullptr) // Undefined variable
             continue;
-        this->parser->variablesList[x->id] = x;
+        this->parser->declareVariable(x);
     }
     this->parser->manager->buildVariableArray(varArray);
     this->parser->manager->endVariableArray();
@@ -206,7 +207,7 @@ void XMLParser::DomainTagAction::beginTag(const AttributeList& attributes) {
     if (forAttr == "others")
         d = static_cast<XMLParser::ArrayTagAction*>(this->parser->getParentTagAction())->domain;
     else {
-        d = DataPool::DomainPool.make<XDomainInteger>();
+        d = DataPool::current().DomainPool.make<XDomainInteger>();
         this->parser->allDomains.push_back(d);
     }
 }
@@ -235,7 +236,7 @@ void XMLParser::DomainTagAction::endTag() {
         varArray->getVarsFor(vars, compactForm, &flatIndexes, true);
         for (unsigned int j = 0; j < flatIndexes.size(); j++) {
             varArray->indexesFor(flatIndexes[j], indexes);
-            varArray->variables[flatIndexes[j]] = DataPool::EntityPool.make<XVariable>(varArray->id, d, indexes);
+            varArray->variables[flatIndexes[j]] = DataPool::current().EntityPool.make<XVariable>(varArray->id, d, indexes);
         }
     }
 }
@@ -284,6 +285,8 @@ void XMLParser::BasicConstraintTagAction::beginTag(const AttributeList& attribut
     this->parser->listTag->nbCallsToList = 0;
     this->parser->lists.clear();
     this->parser->lists.push_back(std::vector<XVariable*>());
+    this->parser->sliceAllowed = false;
+    this->parser->slice = XArraySlice();
     this->parser->matrix.clear();
     this->parser->patterns.clear();
 
@@ -314,7 +317,7 @@ void XMLParser::ExtensionTagAction::beginTag(const AttributeList& attributes) {
     // Must be called inside a constraint
     BasicConstraintTagAction::beginTag(attributes);
 
-    constraint = DataPool::ConstraintPool.make<XConstraintExtension>(this->id, this->parser->classes);
+    constraint = DataPool::current().ConstraintPool.make<XConstraintExtension>(XString(this->id), XString(this->parser->classes));
 
     // Link constraint to group
     if (this->group != NULL) {
@@ -345,7 +348,7 @@ void XMLParser::IntensionTagAction::beginTag(const AttributeList& attributes) {
     // Must be called inside a constraint
     BasicConstraintTagAction::beginTag(attributes);
 
-    constraint = DataPool::ConstraintPool.make<XConstraintIntension>(this->id, this->parser->classes);
+    constraint = DataPool::current().ConstraintPool.make<XConstraintIntension>(XString(this->id), XString(this->parser->classes));
 
     // Link constraint to group
     if (this->group != NULL) {
@@ -384,7 +387,7 @@ void XMLParser::RegularTagAction::beginTag(const AttributeList& attributes) {
     // Must be called inside a constraint
     BasicConstraintTagAction::beginTag(attributes);
 
-    constraint = DataPool::ConstraintPool.make<XConstraintRegular>(this->id, this->parser->classes);
+    constraint = DataPool::current().ConstraintPool.make<XConstraintRegular>(XString(this->id), XString(this->parser->classes));
 
     // Link constraint to group
     if (this->group != NULL) {
@@ -414,7 +417,7 @@ void XMLParser::MDDTagAction::beginTag(const AttributeList& attributes) {
     // Must be called inside a constraint
     BasicConstraintTagAction::beginTag(attributes);
 
-    constraint = DataPool::ConstraintPool.make<XConstraintMDD>(this->id, this->parser->classes);
+    constraint = DataPool::current().ConstraintPool.make<XConstraintMDD>(XString(this->id), XString(this->parser->classes));
 
     // Link constraint to group
     if (this->group != NULL) {
@@ -452,12 +455,13 @@ void XMLParser::AllDiffEqualTagAction::beginTag(const AttributeList& attributes)
     BasicConstraintTagAction::beginTag(attributes);
 
     if (this->tagName == "allDifferent") {
-        alldiff = DataPool::ConstraintPool.make<XConstraintAllDiff>(this->id, this->parser->classes);
+        alldiff = DataPool::current().ConstraintPool.make<XConstraintAllDiff>(XString(this->id), XString(this->parser->classes));
         ct = alldiff;
     } else {
-        allequal = DataPool::ConstraintPool.make<XConstraintAllEqual>(this->id, this->parser->classes);
+        allequal = DataPool::current().ConstraintPool.make<XConstraintAllEqual>(XString(this->id), XString(this->parser->classes));
         ct = allequal;
     }
+    this->parser->sliceAllowed = this->group == NULL && this->parser->manager->callback->nativeArraySlices;
 
     // Link constraint to group
     if (this->group != NULL) {
@@ -479,18 +483,21 @@ void XMLParser::AllDiffEqualTagAction::endTag() {
         throw std::runtime_error("AllDiff matrix and AllDiff lists are not implemented with groups");
 
     if (this->group == NULL) {
+        bool alone = this->parser->lists.size() == 1 && this->parser->matrix.empty() && this->parser->integers.empty();
+        if (this->parser->postSlice(this->tagName == "allDifferent" ? ConstraintType::ALLDIFF : ConstraintType::ALLEQUAL, ct, alone))
+            return;
         if (this->tagName == "allDifferent") {
             if (this->parser->lists.size() > 1) {
                 if (this->parser->integers.size() > 0) // Except not implemented
                     throw std::runtime_error("except tag not allowed with alldiff on lists");
 
-                XConstraintAllDiffList* ctl = DataPool::ConstraintPool.make<XConstraintAllDiffList>(this->id, this->parser->classes);
+                XConstraintAllDiffList* ctl = DataPool::current().ConstraintPool.make<XConstraintAllDiffList>(XString(this->id), XString(this->parser->classes));
                 for (unsigned int i = 0; i < this->parser->lists.size(); i++)
                     ctl->matrix.push_back(std::vector<XVariable*>(this->parser->lists[i].begin(), this->parser->lists[i].end()));
                 this->parser->manager->newConstraintAllDiffList(ctl);
             } else {
                 if (this->parser->matrix.size() > 0) { // Matrix
-                    XConstraintAllDiffMatrix* ctm = DataPool::ConstraintPool.make<XConstraintAllDiffMatrix>(this->id, this->parser->classes, this->parser->matrix);
+                    XConstraintAllDiffMatrix* ctm = DataPool::current().ConstraintPool.make<XConstraintAllDiffMatrix>(XString(this->id), XString(this->parser->classes), this->parser->matrix);
                     this->parser->manager->newConstraintAllDiffMatrix(ctm);
                 } else {
                     // Alldiff classic
@@ -521,7 +528,7 @@ void XMLParser::OrderedTagAction::beginTag(const AttributeList& attributes) {
     // Must be called inside a constraint
     BasicConstraintTagAction::beginTag(attributes);
 
-    constraint = DataPool::ConstraintPool.make<XConstraintOrdered>(this->id, this->parser->classes);
+    constraint = DataPool::current().ConstraintPool.make<XConstraintOrdered>(XString(this->id), XString(this->parser->classes));
     std::string cs;
     attributes["case"].to(cs);
     if (cs == "strictlyDecreasing")
@@ -532,6 +539,7 @@ void XMLParser::OrderedTagAction::beginTag(const AttributeList& attributes) {
         this->parser->op = OrderType::LT;
     if (cs == "increasing")
         this->parser->op = OrderType::LE;
+    this->parser->sliceAllowed = this->group == NULL && this->parser->manager->callback->nativeArraySlices;
 
     // Link constraint to group
     if (this->group != NULL) {
@@ -546,8 +554,10 @@ void XMLParser::OrderedTagAction::text(const UTF8String txt, bool) {
 }
 
 void XMLParser::OrderedTagAction::endTag() {
-    constraint->list.assign(this->parser->lists[0].begin(), this->parser->lists[0].end());
     constraint->op = this->parser->op;
+    if (this->group == NULL && this->parser->postSlice(ConstraintType::ORDERED, constraint, this->parser->lengths.empty()))
+        return;
+    constraint->list.assign(this->parser->lists[0].begin(), this->parser->lists[0].end());
     if (this->parser->lengths.size() > 0)
         constraint->lengths.assign(this->parser->lengths.begin(), this->parser->lengths.end());
 
@@ -564,7 +574,7 @@ void XMLParser::LexTagAction::beginTag(const AttributeList& attributes) {
     // Must be called inside a constraint
     BasicConstraintTagAction::beginTag(attributes);
 
-    constraint = DataPool::ConstraintPool.make<XConstraintLex>(this->id, this->parser->classes);
+    constraint = DataPool::current().ConstraintPool.make<XConstraintLex>(XString(this->id), XString(this->parser->classes));
 
     // Link constraint to group
     if (this->group != NULL) {
@@ -575,7 +585,7 @@ void XMLParser::LexTagAction::beginTag(const AttributeList& attributes) {
 
 void XMLParser::LexTagAction::endTag() {
     if (this->parser->matrix.size() > 0) {
-        XConstraintLexMatrix* lexM = DataPool::ConstraintPool.make<XConstraintLexMatrix>(this->id, this->parser->classes);
+        XConstraintLexMatrix* lexM = DataPool::current().ConstraintPool.make<XConstraintLexMatrix>(XString(this->id), XString(this->parser->classes));
         lexM->op = this->parser->op;
         for (unsigned int i = 0; i < this->parser->matrix.size(); i++)
             lexM->matrix.push_back(
@@ -611,7 +621,8 @@ void XMLParser::SumTagAction::beginTag(const AttributeList& attributes) {
     // Must be called inside a constraint
     BasicConstraintTagAction::beginTag(attributes);
 
-    constraint = DataPool::ConstraintPool.make<XConstraintSum>(this->id, this->parser->classes);
+    constraint = DataPool::current().ConstraintPool.make<XConstraintSum>(XString(this->id), XString(this->parser->classes));
+    this->parser->sliceAllowed = this->group == NULL && this->parser->manager->callback->nativeArraySlices;
 
     // Link constraint to group
     if (this->group != NULL) {
@@ -621,14 +632,15 @@ void XMLParser::SumTagAction::beginTag(const AttributeList& attributes) {
 }
 
 void XMLParser::SumTagAction::endTag() {
+    constraint->condition = this->parser->condition;
+    if (this->group == NULL && this->parser->postSlice(ConstraintType::SUM, constraint, this->parser->values.empty()))
+        return;
     constraint->list.assign(this->parser->lists[0].begin(), this->parser->lists[0].end());
     if (this->parser->values.size() == 0)
         constraint->values.clear();
     else
         constraint->values.assign(this->parser->values.begin(), this->parser->values.end());
 
-    constraint->condition = this->parser->condition;
-
     if (this->group == NULL) {
         this->parser->manager->newConstraintSum(constraint);
     }
@@ -643,7 +655,7 @@ void XMLParser::NValuesTagAction::beginTag(const AttributeList& attributes) {
     // Must be called inside a constraint
     BasicConstraintTagAction::beginTag(attributes);
 
-    constraint = DataPool::ConstraintPool.make<XConstraintNValues>(this->id, this->parser->classes);
+    constraint = DataPool::current().ConstraintPool.make<XConstraintNValues>(XString(this->id), XString(this->parser->classes));
 
     // Link constraint to group
     if (this->group != NULL) {
@@ -670,7 +682,7 @@ void XMLParser::CountTagAction::beginTag(const AttributeList& attributes) {
     // Must be called inside a constraint
     BasicConstraintTagAction::beginTag(attributes);
 
-    constraint = DataPool::ConstraintPool.make<XConstraintCount>(this->id, this->parser->classes);
+    constraint = DataPool::current().ConstraintPool.make<XConstraintCount>(XString(this->id), XString(this->parser->classes));
 
     // Link constraint to group
     if (this->group != NULL) {
@@ -697,7 +709,7 @@ void XMLParser::CardinalityTagAction::beginTag(const AttributeList& attributes)
     // Must be called inside a constraint
     BasicConstraintTagAction::beginTag(attributes);
     this->parser->closed = false;
-    constraint = DataPool::ConstraintPool.make<XConstraintCardinality>(this->id, this->parser->classes);
+    constraint = DataPool::current().ConstraintPool.make<XConstraintCardinality>(XString(this->id), XString(this->parser->classes));
 
     // Link constraint to group
     if (this->group != NULL) {
@@ -730,7 +742,7 @@ void XMLParser::ChannelTagAction::beginTag(const AttributeList& attributes) {
     // Must be called inside a constraint
     BasicConstraintTagAction::beginTag(attributes);
 
-    constraint = DataPool::ConstraintPool.make<XConstraintChannel>(this->id, this->parser->classes);
+    constraint = DataPool::current().ConstraintPool.make<XConstraintChannel>(XString(this->id), XString(this->parser->classes));
 
     // Link constraint to group
     if (this->group != NULL) {
@@ -773,7 +785,7 @@ void XMLParser::ElementTagAction::beginTag(const AttributeList& attributes) {
     // Must be called inside a constraint
     BasicConstraintTagAction::beginTag(attributes);
 
-    constraint = DataPool::ConstraintPool.make<XConstraintElement>(this->id, this->parser->classes);
+    constraint = DataPool::current().ConstraintPool.make<XConstraintElement>(XString(this->id), XString(this->parser->classes));
 
     // Link constraint to group
     if (this->group != NULL) {
@@ -794,7 +806,7 @@ void XMLParser::ElementTagAction::endTag() {
 
     XConstraintElementMatrix* c;
     if (this->parser->matrix.size() > 0) {
-        c = DataPool::ConstraintPool.make<XConstraintElementMatrix>(this->id, this->parser->classes, this->parser->matrix);
+        c = DataPool::current().ConstraintPool.make<XConstraintElementMatrix>(XString(this->id), XString(this->parser->classes), this->parser->matrix);
         c->value = this->parser->values[0];
         c->index = this->parser->index;
         c->rank = this->parser->rank;
@@ -827,7 +839,7 @@ void XMLParser::MinMaxTagAction::beginTag(const AttributeList& attributes) {
     // Must be called inside a constraint
     BasicConstraintTagAction::beginTag(attributes);
 
-    constraint = DataPool::ConstraintPool.make<XConstraintMaximum>(this->id, this->parser->classes);
+    constraint = DataPool::current().ConstraintPool.make<XConstraintMaximum>(XString(this->id), XString(this->parser->classes));
 
     // Link constraint to group
     if (this->group != NULL) {
@@ -867,7 +879,7 @@ void XMLParser::MinMaxTagAction::endTag() {
 void XMLParser::StretchTagAction::beginTag(const AttributeList& attributes) {
     // Must be called inside a constraint
     BasicConstraintTagAction::beginTag(attributes);
-    constraint = DataPool::ConstraintPool.make<XConstraintStretch>(this->id, this->parser->classes);
+    constraint = DataPool::current().ConstraintPool.make<XConstraintStretch>(XString(this->id), XString(this->parser->classes));
     // Link constraint to group
     if (this->group != NULL) {
         this->group->constraint = constraint;
@@ -884,8 +896,8 @@ void XMLParser::StretchTagAction::endTag() {
     }
 
     for (unsigned int i = 0; i < this->parser->widths.size(); i++) {
-        XIntegerInterval* xrange = dynamic_cast<XIntegerInterval*>(this->parser->widths[i]);
-        constraint->widths.push_back(XInterval(xrange->min, xrange->max));
+        XIntegerEntity* xrange = this->parser->widths[i];
+        constraint->widths.push_back(XInterval(xrange->minimum(), xrange->maximum()));
     }
 
     if (this->parser->patterns.size() > 0) {
@@ -908,7 +920,7 @@ void XMLParser::NoOverlapTagAction::beginTag(const AttributeList& attributes) {
     // Must be called inside a constraint
     BasicConstraintTagAction::beginTag(attributes);
     diffn = false;
-    constraint = DataPool::ConstraintPool.make<XConstraintNoOverlap>(this->id, this->parser->classes);
+    constraint = DataPool::current().ConstraintPool.make<XConstraintNoOverlap>(XString(this->id), XString(this->parser->classes));
     if (!attributes["zeroIgnored"].isNull()) {
         std::string tmp;
         attributes["zeroIgnored"].to(tmp);
@@ -941,7 +953,7 @@ void XMLParser::CumulativeTagAction::beginTag(const AttributeList& attributes) {
     // Must be called inside a constraint
     BasicConstraintTagAction::beginTag(attributes);
 
-    constraint = DataPool::ConstraintPool.make<XConstraintCumulative>(this->id, this->parser->classes);
+    constraint = DataPool::current().ConstraintPool.make<XConstraintCumulative>(XString(this->id), XString(this->parser->classes));
 
     // Link constraint to group
     if (this->group != NULL) {
@@ -971,7 +983,7 @@ void XMLParser::CumulativeTagAction::endTag() {
 void XMLParser::CircuitTagAction::beginTag(const AttributeList& attributes) {
     BasicConstraintTagAction::beginTag(attributes);
 
-    constraint = DataPool::ConstraintPool.make<XConstraintCircuit>(this->id, this->parser->classes);
+    constraint = DataPool::current().ConstraintPool.make<XConstraintCircuit>(XString(this->id), XString(this->parser->classes));
 
     // Link constraint to group
     if (this->group != NULL) {
@@ -1011,7 +1023,7 @@ void XMLParser::CircuitTagAction::endTag() {
 
 // AttributeList &attributes
 void XMLParser::ObjectivesTagAction::beginTag(const AttributeList&) {
-    objective = DataPool::ObjectivePool.make<XObjective>();
+    objective = DataPool::current().ObjectivePool.make<XObjective>();
     this->parser->expr = "";
     this->checkParentTag("instance");
     this->parser->lists.clear();
@@ -1207,7 +1219,7 @@ void XMLParser::StringTagAction::text(const UTF8String txt, bool) {
 void XMLParser::InstantiationTagAction::beginTag(const AttributeList& attributes) {
     // Must be called inside a constraint
     BasicConstraintTagAction::beginTag(attributes);
-    constraint = DataPool::ConstraintPool.make<XConstraintInstantiation>(this->id, this->parser->classes);
+    constraint = DataPool::current().ConstraintPool.make<XConstraintInstantiation>(XString(this->id), XString(this->parser->classes));
     // Link constraint to group
     if (this->group != NULL) {
         this->group->constraint = constraint;
@@ -1235,7 +1247,7 @@ void XMLParser::InstantiationTagAction::endTag() {
 void XMLParser::ClauseTagAction::beginTag(const AttributeList& attributes) {
     // Must be called inside a constraint
     BasicConstraintTagAction::beginTag(attributes);
-    constraint = DataPool::ConstraintPool.make<XConstraintClause>(this->id, this->parser->classes);
+    constraint = DataPool::current().ConstraintPool.make<XConstraintClause>(XString(this->id), XString(this->parser->classes));
     literals.clear();
     // Link constraint to group
     if (this->group != NULL) {
@@ -1358,14 +1370,15 @@ void XMLParser::GroupTagAction::beginTag(const AttributeList& attributes) {
     if (!attributes["class"].isNull())
         attributes["class"].to(tmp);
 
-    group = DataPool::ConstraintPool.make<XConstraintGroup>(lid, tmp);
+    group = DataPool::current().ConstraintPool.make<XConstraintGroup>(XString(lid), XString(tmp));
     this->parser->manager->beginGroup(lid);
-    XParameterVariable::max = -1;
+    this->parser->maxParameter = -1;
 }
 
 void XMLParser::GroupTagAction::endTag() {
     if (group->constraint == NULL)
         throw std::runtime_error("<group> constraint is not linked to a classical constraint");
+    group->maxParameter = this->parser->maxParameter;
     this->parser->manager->newConstraintGroup(group);
     this->parser->manager->endGroup();
 }
@@ -1386,7 +1399,7 @@ void XMLParser::SlideTagAction::beginTag(const AttributeList& attributes) {
     if (!attributes["class"].isNull())
         attributes["class"].to(tmp);
 
-    group = DataPool::ConstraintPool.make<XConstraintGroup>(lid, tmp);
+    group = DataPool::current().ConstraintPool.make<XConstraintGroup>(XString(lid), XString(tmp));
     this->parser->lists.clear();
     this->parser->listTag->nbCallsToList = 0;
     this->parser->lists.push_back(std::vector<XVariable*>()); // Be careful, why not ?? see after revision e32b7f8
@@ -1422,6 +1435,7 @@ void XMLParser::SlideTagAction::endTag() {
         }
     }
 
+    group->maxParameter = this->parser->maxParameter;
     this->parser->manager->newConstraintGroup(group);
     this->parser->manager->endSlide();
 }